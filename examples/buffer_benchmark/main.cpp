@@ -0,0 +1,55 @@
+#include <network/common/buffer.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "CLI/CLI.hpp"
+
+using namespace bro::net;
+
+/*! \brief fill buffer with backlog and drain it with partial "writes"
+ *  \return drain time in nanoseconds
+ */
+uint64_t drain_backlog(size_t backlog, size_t message_size, size_t write_size, uint64_t &checksum) {
+  std::vector<std::byte> message(message_size, std::byte{1});
+  buffer buf;
+  for (size_t filled = 0; filled < backlog; filled += message_size)
+    buf.append(message.data(), message_size);
+
+  auto start = std::chrono::steady_clock::now();
+  while (!buf.is_empty()) {
+    auto [data, size] = buf.get_data();
+    // socket accepts only part of the segment (like slow peer)
+    size_t const sent = size < write_size ? size : write_size;
+    checksum += (uint64_t) data[sent - 1];
+    buf.erase(sent);
+  }
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+int main(int argc, char **argv) {
+  CLI::App app{"buffer_benchmark"};
+  size_t message_size = 1500;
+  size_t write_size = 4096;
+  size_t max_backlog = 64 * 1024 * 1024;
+
+  app.add_option("-s,--message_size", message_size, "size of one appended message");
+  app.add_option("-w,--write_size", write_size, "bytes drained per partial write");
+  app.add_option("-m,--max_backlog", max_backlog, "max backlog size in bytes");
+  CLI11_PARSE(app, argc, argv);
+
+  if (!message_size || !write_size) {
+    std::cerr << "message size and write size must be positive" << std::endl;
+    return -1;
+  }
+
+  uint64_t checksum = 0;
+  std::cout << "backlog(bytes)\tdrain(ns)\tns per byte" << std::endl;
+  for (size_t backlog = 64 * 1024; backlog <= max_backlog; backlog *= 4) {
+    uint64_t const drain_ns = drain_backlog(backlog, message_size, write_size, checksum);
+    std::cout << backlog << "\t" << drain_ns << "\t" << double(drain_ns) / double(backlog) << std::endl;
+  }
+  std::cout << "checksum - " << checksum << std::endl;
+}
@@ -0,0 +1,183 @@
+#include <network/stream/factory.h>
+#include <network/tcp/listen/settings.h>
+#include <network/tcp/send/settings.h>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "CLI/CLI.hpp"
+
+using namespace bro::net;
+using namespace bro::strm;
+
+/*! \brief user data which doesn't fit into small buffer of std::any (copied with heap allocation)
+ */
+struct big_param {
+  std::array<uint64_t, 8> _data{};
+};
+
+/*! \brief consumer of events. it is called by callback and by handler
+ */
+struct consumer {
+  /*! \brief read all data from stream
+   */
+  void consume(bro::strm::stream *st) {
+    ++_events;
+    if (!st) {
+      ++_received;
+      return;
+    }
+    for (ssize_t rec = st->receive(_buffer.data(), _buffer.size()); rec > 0;
+         rec = st->receive(_buffer.data(), _buffer.size()))
+      _received += (size_t) rec;
+  }
+
+  std::vector<std::byte> _buffer = std::vector<std::byte>(64 * 1024);
+  size_t _received = 0;
+  size_t _events = 0;
+};
+
+/*! \brief handler which passes events to consumer
+ */
+struct consumer_handler : stream_handler {
+  void on_data(bro::strm::stream *st) override { _consumer->consume(st); }
+  consumer *_consumer = nullptr;
+};
+
+/*! \brief callback which passes events to consumer (user data is pointer)
+ */
+void on_received_data(bro::strm::stream *st, std::any param) {
+  std::any_cast<consumer *>(param)->consume(st);
+}
+
+/*! \brief callback with user data which is copied with heap allocation
+ */
+void on_received_big_data(bro::strm::stream *st, std::any param) {
+  auto const &big = std::any_cast<big_param const &>(param);
+  reinterpret_cast<consumer *>(big._data[0])->consume(st);
+}
+
+/*! \brief elapsed nanoseconds
+ */
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+/*! \brief dispatch events like stream does it (without sockets)
+ */
+void dispatch_benchmark(size_t events) {
+  consumer cons;
+  received_data_cb cb = on_received_data;
+  std::any param = &cons;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < events; ++i)
+    cb(nullptr, param);
+  uint64_t const function_ns = elapsed_ns(start);
+
+  big_param big;
+  big._data[0] = reinterpret_cast<uint64_t>(&cons);
+  received_data_cb big_cb = on_received_big_data;
+  std::any big_any = big;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < events; ++i)
+    big_cb(nullptr, big_any);
+  uint64_t const big_function_ns = elapsed_ns(start);
+
+  consumer_handler handler;
+  handler._consumer = &cons;
+  // prevent devirtualization
+  stream_handler *volatile handler_ptr = &handler;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < events; ++i)
+    handler_ptr->on_data(nullptr);
+  uint64_t const handler_ns = elapsed_ns(start);
+
+  std::cout << "dispatch only (" << events << " events, checksum " << cons._received << ")" << std::endl;
+  std::cout << "  std::function + std::any(pointer)\t" << double(function_ns) / double(events) << " ns per event"
+            << std::endl;
+  std::cout << "  std::function + std::any(" << sizeof(big_param) << " bytes)\t"
+            << double(big_function_ns) / double(events) << " ns per event" << std::endl;
+  std::cout << "  stream_handler\t\t\t" << double(handler_ns) / double(events) << " ns per event" << std::endl;
+}
+
+/*! \brief send messages over loopback and receive them with callback or handler
+ *  \return nanoseconds per message (0 on error)
+ */
+uint64_t loopback_benchmark(uint16_t port, size_t messages, size_t message_size, bool use_handler) {
+  ev::factory manager;
+  consumer cons;
+  consumer_handler handler;
+  handler._consumer = &cons;
+  stream_ptr server;
+
+  tcp::listen::settings listen_settings;
+  listen_settings._listen_address = {proto::ip::address("127.0.0.1"), port};
+  listen_settings._proc_in_conn = [&](stream_ptr &&stream, std::any) {
+    if (use_handler)
+      stream->set_handler(&handler, false);
+    else
+      stream->set_received_data_cb(on_received_data, &cons);
+    manager.bind(stream);
+    server = std::move(stream);
+  };
+  auto listen_stream = manager.create_stream(&listen_settings);
+  if (!listen_stream->is_active()) {
+    std::cerr << "couldn't create listen stream, cause - " << listen_stream->get_error_description() << std::endl;
+    return 0;
+  }
+  manager.bind(listen_stream);
+
+  tcp::send::settings client_settings;
+  client_settings._peer_addr = listen_settings._listen_address;
+  auto client = manager.create_stream(&client_settings);
+  manager.bind(client);
+  while (!server && client->is_active())
+    manager.proceed();
+  if (!server) {
+    std::cerr << "couldn't connect, cause - " << client->get_error_description() << std::endl;
+    return 0;
+  }
+
+  std::vector<std::byte> message(message_size, std::byte{1});
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < messages && client->is_active(); ++i) {
+    client->send(message.data(), message.size());
+    // one message per read event
+    while (cons._received < (i + 1) * message_size && server->is_active())
+      manager.proceed();
+  }
+  uint64_t const ns = elapsed_ns(start);
+  server.reset();
+  client.reset();
+  return cons._received == messages * message_size ? ns / messages : 0;
+}
+
+int main(int argc, char **argv) {
+  CLI::App app{"callback_benchmark"};
+  size_t events = 100000000;
+  size_t messages = 100000;
+  size_t message_size = 64;
+  uint16_t port = 22345;
+
+  app.add_option("-e,--events", events, "number of dispatched events without sockets");
+  app.add_option("-m,--messages", messages, "number of messages sent over loopback");
+  app.add_option("-s,--message_size", message_size, "size of one message");
+  app.add_option("-p,--port", port, "port of loopback server");
+  CLI11_PARSE(app, argc, argv);
+
+  if (!events || !messages || !message_size) {
+    std::cerr << "events, messages and message size must be positive" << std::endl;
+    return -1;
+  }
+
+  dispatch_benchmark(events);
+
+  uint64_t const function_ns = loopback_benchmark(port, messages, message_size, false);
+  uint64_t const handler_ns = loopback_benchmark(port, messages, message_size, true);
+  std::cout << "loopback (" << messages << " messages of " << message_size << " bytes)" << std::endl;
+  std::cout << "  std::function + std::any\t" << function_ns << " ns per message" << std::endl;
+  std::cout << "  stream_handler\t\t" << handler_ns << " ns per message" << std::endl;
+}
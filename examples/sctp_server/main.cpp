@@ -40,7 +40,7 @@ void received_data_cb(stream *stream, std::any data_com) {
         std::cout << "send error - " << stream->get_error_description() << std::endl;
       cdata->_need_to_handle.insert(stream);
     }
-  } else {
+  } else if (size < 0) {
     if (print_debug_info)
       std::cout << "error message - " << stream->get_error_description() << std::endl;
     cdata->_need_to_handle.insert(stream);
@@ -1,4 +1,8 @@
+#include <network/stream/epoll_factory.h>
 #include <network/stream/factory.h>
+#ifdef WITH_IO_URING
+#include <network/stream/uring_factory.h>
+#endif // WITH_IO_URING
 #include <network/tcp/send/settings.h>
 #include <network/tcp/send/statistic.h>
 #include <protocols/ip/full_address.h>
@@ -12,10 +16,33 @@
 #include "CLI/CLI.hpp"
 
 bool print_debug_info = false;
+bool use_epoll = false;
+bool use_io_uring = false;
 
 using namespace bro::net;
 using namespace bro::strm;
 
+/*! \brief create event loop
+ *  \return factory (epoll/io_uring one if it was requested and supported)
+ */
+std::unique_ptr<bro::strm::factory> make_factory() {
+#ifdef WITH_IO_URING
+  if (use_io_uring) {
+    auto manager = std::make_unique<uring::factory>();
+    if (manager->is_active())
+      return manager;
+    std::cerr << "couldn't init io_uring, cause - " << manager->get_error_description() << std::endl;
+  }
+#endif // WITH_IO_URING
+  if (use_epoll) {
+    auto manager = std::make_unique<epoll::factory>();
+    if (manager->is_active())
+      return manager;
+    std::cerr << "couldn't init epoll, cause - " << manager->get_error_description() << std::endl;
+  }
+  return std::make_unique<ev::factory>();
+}
+
 struct per_thread_data {
   std::thread _thread;
   tcp::send::statistic _stat;
@@ -69,7 +96,7 @@ void thread_fun(proto::ip::address const &server_addr,
                 size_t data_size) {
   tcp::send::settings settings;
 
-  ev::factory manager;
+  auto manager = make_factory();
   settings._peer_addr = {server_addr, server_port};
   std::vector<std::byte> initial_data;
   fillTestData(thread_number, initial_data, data_size);
@@ -78,9 +105,9 @@ void thread_fun(proto::ip::address const &server_addr,
   size_t count = 0;
   while (work.load(std::memory_order_acquire)) {
     if (stream_pool.size() < connections_per_thread) {
-      auto new_stream = manager.create_stream(&settings);
+      auto new_stream = manager->create_stream(&settings);
       if (new_stream->is_active()) {
-        manager.bind(new_stream);
+        manager->bind(new_stream);
         new_stream->set_received_data_cb(::received_data_cb, &count);
         new_stream->set_state_changed_cb(::state_changed_cb, &need_to_handle);
         new_stream->send(initial_data.data(), initial_data.size());
@@ -104,7 +131,7 @@ void thread_fun(proto::ip::address const &server_addr,
     }
     count = 0;
 
-    manager.proceed();
+    manager->proceed();
   }
 
   for (auto &strm : stream_pool) {
@@ -128,6 +155,10 @@ int main(int argc, char **argv) {
   app.add_option("-d,--data", data_size, "send data size");
   app.add_option("-t,--test_time", test_time, "test time in seconds");
   app.add_option("-c,--connecions", connections_per_thread, "connections per thread");
+  app.add_option("-e,--epoll", use_epoll, "use edge triggered epoll factory");
+#ifdef WITH_IO_URING
+  app.add_option("-u,--io_uring", use_io_uring, "use io_uring factory");
+#endif // WITH_IO_URING
   CLI11_PARSE(app, argc, argv);
 
   proto::ip::address server_address(server_address_string);
@@ -1,4 +1,9 @@
+#include <network/stream/epoll_factory.h>
 #include <network/stream/factory.h>
+#include <network/stream/send/stream.h>
+#ifdef WITH_IO_URING
+#include <network/stream/uring_factory.h>
+#endif // WITH_IO_URING
 #include <network/tcp/listen/settings.h>
 #include <network/tcp/listen/statistic.h>
 #include <network/tcp/send/settings.h>
@@ -14,41 +19,55 @@
 #include "CLI/CLI.hpp"
 
 bool print_debug_info = false;
-size_t data_size = 65000;
+bool use_epoll = false;
+bool use_io_uring = false;
 
 using namespace bro::net;
 using namespace bro::strm;
 
+/*! \brief create event loop
+ *  \return factory (epoll/io_uring one if it was requested and supported)
+ */
+std::unique_ptr<bro::strm::factory> make_factory() {
+#ifdef WITH_IO_URING
+  if (use_io_uring) {
+    auto manager = std::make_unique<uring::factory>();
+    if (manager->is_active())
+      return manager;
+    std::cerr << "couldn't init io_uring, cause - " << manager->get_error_description() << std::endl;
+  }
+#endif // WITH_IO_URING
+  if (use_epoll) {
+    auto manager = std::make_unique<epoll::factory>();
+    if (manager->is_active())
+      return manager;
+    std::cerr << "couldn't init epoll, cause - " << manager->get_error_description() << std::endl;
+  }
+  return std::make_unique<ev::factory>();
+}
+
 struct data_per_thread {
-  std::unordered_set<stream *> _need_to_handle;
-  std::unordered_map<stream *, stream_ptr> _streams;
+  std::unordered_set<bro::strm::stream *> _need_to_handle;
+  std::unordered_map<bro::strm::stream *, stream_ptr> _streams;
   size_t _count = 0;
-  ev::factory *_manager;
+  bro::strm::factory *_manager;
 };
 
-void received_data_cb(stream *stream, std::any data_com) {
-  std::byte data[data_size];
+size_t received_data_cb(bro::strm::stream *stream, std::byte const *data, size_t size, std::any data_com) {
   data_per_thread *cdata = std::any_cast<data_per_thread *>(data_com);
   cdata->_count++;
-  ssize_t size = stream->receive(data, data_size);
-  if (size > 0) {
+  if (print_debug_info)
+    std::cout << "receive message - " << std::string((char const *) data, size) << std::endl;
+  ssize_t const sent = stream->send(data, size);
+  if (sent <= 0) {
     if (print_debug_info)
-      std::cout << "receive message - " << std::string((char *) data, size) << std::endl;
-    ssize_t const sent = stream->send(data, size);
-    if (sent <= 0) {
-      if (print_debug_info)
-        std::cout << "send error - " << stream->get_error_description() << std::endl;
-      cdata->_need_to_handle.insert(stream);
-    }
-  } else {
-    if (print_debug_info)
-      std::cout << "error message - " << stream->get_error_description() << std::endl;
+      std::cout << "send error - " << stream->get_error_description() << std::endl;
     cdata->_need_to_handle.insert(stream);
-    return;
   }
+  return size;
 }
 
-void state_changed_cb(stream *stream, std::any data_com) {
+void state_changed_cb(bro::strm::stream *stream, std::any data_com) {
   if (!stream->is_active()) {
     std::cout << "state_changed_cb " << stream->get_state() << ", " << stream->get_error_description() << std::endl;
     data_per_thread *cdata = std::any_cast<data_per_thread *>(data_com);
@@ -67,7 +86,7 @@ auto in_connections = [](stream_ptr &&stream, tcp::listen::settings::in_conn_han
             << std::endl;
 
   auto *cdata = std::any_cast<data_per_thread *>(data);
-  stream->set_received_data_cb(::received_data_cb, data);
+  static_cast<send::stream *>(stream.get())->set_received_view_cb(::received_data_cb, data);
   stream->set_state_changed_cb(::state_changed_cb, data);
   cdata->_manager->bind(stream);
   cdata->_streams[stream.get()] = std::move(stream);
@@ -82,8 +101,11 @@ int main(int argc, char **argv) {
   app.add_option("-a,--address", server_address_s, "server address")->required();
   app.add_option("-p,--port", server_port, "server port")->required();
   app.add_option("-l,--log", print_debug_info, "print debug info");
-  app.add_option("-d,--data", data_size, "send data size")->type_size(1, std::numeric_limits<std::uint16_t>::max());
   app.add_option("-t,--test_time", test_time, "test time in seconds");
+  app.add_option("-e,--epoll", use_epoll, "use edge triggered epoll factory");
+#ifdef WITH_IO_URING
+  app.add_option("-u,--io_uring", use_io_uring, "use io_uring factory");
+#endif // WITH_IO_URING
   CLI11_PARSE(app, argc, argv);
 
   proto::ip::address server_address(server_address_s);
@@ -92,21 +114,21 @@ int main(int argc, char **argv) {
     return -1;
   }
 
-  ev::factory manager;
+  auto manager = make_factory();
   tcp::listen::settings settings;
   std::atomic_bool work(true);
 
   data_per_thread cdata;
-  cdata._manager = &manager;
+  cdata._manager = manager.get();
   settings._listen_address = {server_address, server_port};
   settings._proc_in_conn = in_connections;
   settings._in_conn_handler_data = &cdata;
-  auto listen_stream = manager.create_stream(&settings);
+  auto listen_stream = manager->create_stream(&settings);
   if (!listen_stream->is_active()) {
     std::cerr << "couldn't create listen stream, cause - " << listen_stream->get_error_description() << std::endl;
     return -1;
   }
-  manager.bind(listen_stream);
+  manager->bind(listen_stream);
 
   auto endTime = std::chrono::system_clock::now() + std::chrono::seconds(test_time);
 
@@ -116,7 +138,7 @@ int main(int argc, char **argv) {
   std::cout << "server start" << std::endl;
 
   while (std::chrono::system_clock::now() < endTime && listen_stream->is_active()) {
-    manager.proceed();
+    manager->proceed();
     if (!cdata._need_to_handle.empty()) {
       auto it = cdata._need_to_handle.begin();
       if (!(*it)->is_active()) {
@@ -152,4 +174,12 @@ int main(int argc, char **argv) {
   std::cout << "success_recv_data - " << client_stat._success_recv_data << std::endl;
   std::cout << "retry_recv_data - " << client_stat._retry_recv_data << std::endl;
   std::cout << "failed_recv_data - " << client_stat._failed_recv_data << std::endl;
+  if (auto *ev_manager = dynamic_cast<ev::factory *>(manager.get()); ev_manager) {
+    std::cout << "interest_updates - " << ev_manager->get_statistic()._interest_updates << std::endl;
+    std::cout << "avoided_epoll_ctl - " << ev_manager->get_statistic()._avoided_epoll_ctl << std::endl;
+    auto const &chunks = ev_manager->get_chunk_pool().get_statistic();
+    std::cout << "chunk_pool_hits - " << chunks._hits << std::endl;
+    std::cout << "chunk_pool_misses - " << chunks._misses << std::endl;
+    std::cout << "chunk_pool_resident_bytes - " << chunks._resident_bytes << std::endl;
+  }
 }
@@ -1,62 +1,161 @@
 #pragma once
-#include <vector>
+#include <array>
+#include <utility>
 #include <stddef.h>
+#include <sys/uio.h>
 
 namespace bro::net {
 
+class chunk_pool;
+
 /** @defgroup common common
  *  @{
  */
 
-/*! \brief A class that represents a buffer of bytes.
- *  The buffer class is a simple implementation of a byte buffer that allows appending and removing bytes
+/*! \brief A class that represents a queue of bytes.
+ *  The buffer is a segmented queue: small backlogs are kept in an inline storage, bigger ones in a chain
+ *  of fixed-size chunks. Appending never moves already stored data and removing from the front is O(1)
+ *  per chunk, hence draining a big backlog with partial writes costs the same per byte at any depth.
  */
 class buffer {
 public:
+  static constexpr size_t default_chunk_size = 16 * 1024; ///< default size of one chunk
+  static constexpr size_t inline_size = 256;              ///< size of inline storage for tiny backlogs
+
+  /*! \brief constructor
+   * \param chunk_size size of one chunk in the chain
+   */
+  explicit buffer(size_t chunk_size = default_chunk_size) noexcept;
+
+  /*! \brief destructor. free all chunks
+   */
+  ~buffer();
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * We don't need to copy chains of chunks
+   */
+  buffer(buffer const &) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * We don't need to copy chains of chunks
+   */
+  buffer &operator=(buffer const &) = delete;
+
+  /**
+   * \brief move ctor
+   */
+  buffer(buffer &&other) noexcept;
+
+  /**
+   * \brief move assign operator
+   */
+  buffer &operator=(buffer &&other) noexcept;
+
+  /*! \brief borrow chunks from pool (chunk size is defined by pool)
+   * \param pool pool of chunks. nullptr - allocate chunks from heap
+   *
+   * \note stored data is moved into chunks of new pool. pool must outlive the buffer
+   */
+  void set_pool(chunk_pool *pool);
+
   /*! \brief  Checks if the buffer is empty.
    * \return True if the buffer is empty, false otherwise.
- */
-  bool is_empty() const noexcept { return _buffer.empty(); }
+   */
+  bool is_empty() const noexcept { return 0 == _size; }
 
-  /*! @brief Gets a pair of pointers to the data in the buffer and the size of the buffer.
-  * If the buffer has data, this method returns a pair of pointers to the data in the buffer and the size of the buffer.
+  /*! \brief  Get number of stored bytes
+   * \return number of bytes in the buffer
+   */
+  size_t size() const noexcept { return _size; }
+
+  /*! @brief Gets a pair of pointers to the first contiguous segment of data and its size.
+  * If the buffer has data, this method returns a pointer to the front segment and the size of this segment.
   * If the buffer is empty, it returns an empty pair.
-  * \return A pair of pointers to the data in the buffer and the size of the buffer.
+  * \return A pair of pointers to the data in the buffer and the size of the segment.
   *
+  * \note segment can be smaller than \ref size. After \ref erase next call returns the next segment
   * \note span doesn't work in my compiler
- */
+  */
   std::pair<std::byte const *, size_t> get_data() const noexcept {
-    if (!is_empty()) {
-      return {_buffer.data(), _buffer.size()};
-    }
+    if (_inline_begin != _inline_end)
+      return {_inline.data() + _inline_begin, _inline_end - _inline_begin};
+    if (_head)
+      return {_head->data() + _head->_begin, _head->_end - _head->_begin};
     return {nullptr, 0};
   }
 
+  /*! \brief Gets contiguous segments of data from the front of the buffer (data isn't removed).
+   * \param vec A pointer to the array of segments to fill.
+   * \param count Max number of segments.
+   * \return number of filled segments (0 if the buffer is empty)
+   */
+  size_t get_segments(iovec *vec, size_t count) const noexcept;
+
+  /*! \brief Copies data from the front of the buffer (data isn't removed).
+   * \param dest A pointer to the destination memory.
+   * \param n The number of bytes to copy.
+   * \return number of copied bytes (less than n if the buffer is smaller)
+   */
+  size_t copy(std::byte *dest, size_t n) const noexcept;
+
   /*! \brief Appends data to the end of the buffer.
    * \param data A pointer to the data to append.
    * \param data_size The size of the data to append.
    */
-  void append(std::byte const *data, size_t data_size) { _buffer.insert(_buffer.end(), data, data + data_size); }
+  void append(std::byte const *data, size_t data_size);
 
   /*! \brief  Removes data from the front of the buffer.
    *  If the size of data to be removed is greater than or equal to the size of the buffer, the buffer is cleared.
    * \param n The number of bytes to remove from the front of the buffer.
- */
-  void erase(size_t n) {
-    if (n >= _buffer.size()) {
-      clear();
-      return;
-    }
-
-    _buffer.erase(_buffer.begin(), _buffer.begin() + n);
-  }
+   */
+  void erase(size_t n);
 
   /*! \brief  Clears the buffer.
-  */
-  void clear() { _buffer.clear(); }
+   */
+  void clear();
 
 private:
-  std::vector<std::byte> _buffer; ///< The underlying byte buffer.
+  /*! \brief one chunk in the chain. data is placed right after the header
+   */
+  struct chunk {
+    chunk *_next = nullptr; ///< next chunk in the chain
+    size_t _begin = 0;      ///< offset of first unread byte
+    size_t _end = 0;        ///< offset of first free byte
+
+    /*! \brief get pointer on chunk data
+     */
+    std::byte *data() noexcept { return reinterpret_cast<std::byte *>(this + 1); }
+
+    /*! \brief get pointer on chunk data
+     */
+    std::byte const *data() const noexcept { return reinterpret_cast<std::byte const *>(this + 1); }
+  };
+
+  /*! \brief get free chunk (reuse spare chunk if exists or borrow it from pool)
+   */
+  chunk *acquire_chunk();
+
+  /*! \brief return drained chunk (keep one as spare to prevent allocation ping-pong or return it to pool)
+   */
+  void release_chunk(chunk *ch) noexcept;
+
+  /*! \brief free all chunks (with spare one)
+   */
+  void free_chunks() noexcept;
+
+  std::array<std::byte, inline_size> _inline; ///< inline storage for tiny backlogs
+  size_t _inline_begin = 0;                   ///< offset of first unread byte in inline storage
+  size_t _inline_end = 0;                     ///< offset of first free byte in inline storage
+  chunk *_head = nullptr;                     ///< first chunk in the chain
+  chunk *_tail = nullptr;                     ///< last chunk in the chain
+  chunk *_spare = nullptr;                    ///< cached free chunk
+  chunk_pool *_pool = nullptr;                ///< pool of chunks (nullptr - chunks are allocated from heap)
+  size_t _chunk_size = default_chunk_size;    ///< capacity of one chunk
+  size_t _size = 0;                           ///< overall stored bytes
 };
 
 } // namespace bro::net
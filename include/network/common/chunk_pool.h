@@ -0,0 +1,151 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace bro::net {
+
+/** @addtogroup common
+ *  @{
+ */
+
+/*! \brief pool of fixed-size chunks.
+ *  Chunks are carved from big slabs (mmap) and are returned into free list, hence streams of one reactor
+ *  reuse the same memory instead of growing/shrinking own heap allocations. Slabs are freed only with pool.
+ *
+ *  \note isn't thread safe. Every reactor (factory) owns own pool
+ */
+class chunk_pool {
+public:
+  /*!
+   * @brief pool parameters
+   */
+  struct config {
+    size_t _chunk_size = 16 * 1024; ///< size of one chunk (rounded up to cache line)
+    size_t _chunks_per_slab = 64;   ///< number of chunks allocated at once
+    bool _huge_pages = false;       ///< back slabs with huge pages (falls back to transparent huge pages)
+  };
+
+  /*!
+   * @brief statistic of pool
+   */
+  struct statistic {
+    /*! \brief reset counters (resident bytes and used chunks are actual values, hence aren't reset)
+     */
+    void reset() {
+      _hits = 0;
+      _misses = 0;
+    }
+
+    /*! \brief add function
+     */
+    statistic &operator+=(statistic const &rhs) {
+      _hits += rhs._hits;
+      _misses += rhs._misses;
+      _resident_bytes += rhs._resident_bytes;
+      _used_chunks += rhs._used_chunks;
+      _huge_page_slabs += rhs._huge_page_slabs;
+      return *this;
+    }
+
+    uint64_t _hits = 0;            ///< chunks taken from free list
+    uint64_t _misses = 0;          ///< chunks which needed new slab
+    uint64_t _resident_bytes = 0;  ///< memory of all slabs
+    uint64_t _used_chunks = 0;     ///< chunks borrowed now
+    uint64_t _huge_page_slabs = 0; ///< slabs backed by explicit huge pages
+  };
+
+  /*! \brief constructor with default config
+   */
+  chunk_pool() noexcept;
+
+  /*! \brief constructor
+   *  \param [in] conf pool parameters
+   */
+  explicit chunk_pool(config const &conf) noexcept;
+
+  /*! \brief destructor. free all slabs
+   *
+   *  \note all chunks must be returned before (streams must be destroyed before factory)
+   */
+  ~chunk_pool();
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * Buffers keep pointer on pool
+   */
+  chunk_pool(chunk_pool const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Buffers keep pointer on pool
+   */
+  chunk_pool(chunk_pool &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * Buffers keep pointer on pool
+   */
+  chunk_pool &operator=(chunk_pool const &) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Buffers keep pointer on pool
+   */
+  chunk_pool &operator=(chunk_pool &&) = delete;
+
+  /*! \brief get size of one chunk
+   *  \return chunk size
+   */
+  size_t get_chunk_size() const noexcept { return _chunk_size; }
+
+  /*! \brief borrow chunk
+   *  \return pointer on chunk (throws std::bad_alloc if memory couldn't be allocated)
+   */
+  void *acquire();
+
+  /*! \brief return chunk into pool
+   *  \param [in] chunk borrowed chunk
+   */
+  void release(void *chunk) noexcept;
+
+  /*! \brief get statistic
+   *  \return statistic
+   */
+  statistic const &get_statistic() const noexcept { return _statistic; }
+
+  /*! \brief reset statistic
+   */
+  void reset_statistic() noexcept { _statistic.reset(); }
+
+private:
+  /*! \brief free chunk. placed in memory of chunk
+   */
+  struct free_chunk {
+    free_chunk *_next; ///< next free chunk
+  };
+
+  /*! \brief allocated slab
+   */
+  struct slab {
+    void *_memory; ///< mapped memory
+    size_t _size;  ///< size of mapped memory
+  };
+
+  /*! \brief allocate new slab and put its chunks into free list
+   */
+  void allocate_slab();
+
+  std::vector<slab> _slabs;    ///< allocated slabs
+  free_chunk *_free = nullptr; ///< free list
+  size_t _chunk_size;          ///< size of one chunk
+  size_t _chunks_per_slab;     ///< number of chunks allocated at once
+  bool _huge_pages;            ///< use explicit huge pages
+  statistic _statistic;        ///< statistic
+};
+
+} // namespace bro::net
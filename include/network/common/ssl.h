@@ -1,5 +1,6 @@
 #pragma once
-#include <openssl/types.h>
+#include <openssl/ssl.h>
+#include <stdint.h>
 #include <string>
 
 namespace bro::net::ssl {
@@ -51,6 +52,64 @@ std::string fill_error(char const *const err, int ssl_error_code = 0);
  */
 std::string fill_error(std::string const &err, int ssl_error_code = 0);
 
+using new_session_cb = int (*)(SSL *ssl, SSL_SESSION *session); ///< callback on new session of client
+
+/*! \brief parameters of client context. Streams with equal parameters share one context
+ */
+struct client_ctx_params {
+  SSL_METHOD const *_method = nullptr;      ///< tls/dtls client method
+  int _min_version = 0;                     ///< min protocol version (0 - default)
+  int _max_version = 0;                     ///< max protocol version (0 - default)
+  uint64_t _options = 0;                    ///< context options
+  long _mode = 0;                           ///< context modes
+  int _verify_depth = -1;                   ///< verify depth if certificate is set (-1 - default)
+  std::string _certificate_path;            ///< path to certificate file (certificate isn't used if empty)
+  std::string _key_path;                    ///< path to key file (certificate isn't used if empty)
+  new_session_cb _new_session_cb = nullptr; ///< callback on new session (sessions are cached by client)
+};
+
+/*! \brief get client context for parameters. Context is created (and certificate is loaded) only for first
+ *  stream with such parameters, other streams take reference on it
+ *  \param [in] params parameters of context
+ *  \param [out] err will be filled with error if something go wrong
+ *  \return pointer on context or nullptr on error
+ *
+ *  \note thread safe. context must be released with \ref release_client_ctx
+ */
+[[nodiscard]] SSL_CTX *acquire_client_ctx(client_ctx_params const &params, std::string &err);
+
+/*! \brief release reference on client context. Context is freed by last stream
+ *  \param [in] ctx context taken with \ref acquire_client_ctx
+ *
+ *  \note thread safe
+ */
+void release_client_ctx(SSL_CTX *ctx);
+
+/*! \brief get prefix of client session key. Session is resumed only with context it was created with
+ *  (other contexts can have other verification settings/certificate)
+ *  \param [in] ctx client context
+ *  \return prefix of keys of sessions created with context
+ */
+std::string get_client_session_prefix(SSL_CTX *ctx);
+
+/*! \brief store client session for resumption. Session replaces previous one with the same key
+ *  \param [in] ctx client context session is created with (\ref acquire_client_ctx)
+ *  \param [in] key key of session (\ref get_client_session_prefix, peer and host name)
+ *  \param [in] session session. cache takes reference on it
+ *
+ *  \note thread safe. cached session keeps reference on context, hence context isn't freed (and its address
+ *  isn't reused) while its sessions are in cache
+ */
+void store_client_session(SSL_CTX *ctx, std::string const &key, SSL_SESSION *session);
+
+/*! \brief get client session for resumption
+ *  \param [in] key key of session (\ref get_client_session_prefix, peer and host name)
+ *  \return session (reference must be freed with SSL_SESSION_free) or nullptr if there is no session
+ *
+ *  \note thread safe
+ */
+[[nodiscard]] SSL_SESSION *get_client_session(std::string const &key);
+
 /*! \brief get salt generated in init phase
  *  \return pointer on salt and salt size
  *
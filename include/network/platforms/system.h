@@ -85,21 +85,37 @@ proto::ip::full_address get_address_from_file_descr(proto::ip::address::version
   * @brief all necessary data about connection
   */
 struct accept_connection_details {
-  proto::ip::full_address _peer_addr;    ///< peer address
-  proto::ip::full_address _self_address; ///< self address
-  int _client_fd;                        ///< file descriptor of current connection
+  proto::ip::full_address _peer_addr; ///< peer address
+  int _client_fd;                     ///< file descriptor of current connection
 };
 
 using accept_connection_res
   = std::optional<accept_connection_details>; ///< result of accept_connection function. filled on success
 
-/*! \brief create new connection with peer
- *  \param [in] server_fd server file descriptor ( on which we listen incomming connections )
+/*! \brief accept new connection with peer (accept4 with SOCK_CLOEXEC)
  *  \param [in] ver - ip protocol version
+ *  \param [in] server_fd server file descriptor ( on which we listen incomming connections )
+ *  \param [in] non_blocking - create connection in non blocking mode (SOCK_NONBLOCK)
  *  \param [out] err - will fill with error if something go wrong
  *  \result filled accept_connection_details on succes. nullopt otherwise
+ *
+ *  \note if there are no pending connections returns nullopt and err isn't changed
+ *  \note self address isn't requested. It is the listen address or can be got from file descriptor
+ */
+[[nodiscard]] accept_connection_res accept_connection(proto::ip::address::version ver,
+                                                      int server_fd,
+                                                      bool non_blocking,
+                                                      std::string &err);
+
+/*! \brief fill connection details for already accepted connection (peer address is got with getpeername)
+ *  \param [in] ver - ip protocol version
+ *  \param [in] client_fd file descriptor of accepted connection
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result filled accept_connection_details on succes. nullopt otherwise (client_fd is closed)
  */
-[[nodiscard]] accept_connection_res accept_connection(proto::ip::address::version ver, int server_fd, std::string &err);
+[[nodiscard]] accept_connection_res accepted_connection(proto::ip::address::version ver,
+                                                        int client_fd,
+                                                        std::string &err);
 
 /*! \brief connect with peer
  *  \param [in] peer_addr - peer address
@@ -116,6 +132,13 @@ using accept_connection_res
  */
 [[nodiscard]] bool reuse_address(int file_descr, std::string &err);
 
+/*! \brief enable reuse port (SO_REUSEPORT). kernel balances incomming connections between sockets on the same port
+ *  \param [in] file_descr  -  self file descriptor
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool reuse_port(int file_descr, std::string &err);
+
 /*! \brief start listen incomming connections on socket (file_descr)
  *  \param [in] file_descr  -  self file descriptor
  *  \param [in] listen_backlog  -  maximum rate at which a server can accept new connections
@@ -161,6 +184,44 @@ bool close_socket(int &file_descr, std::string &err);
  */
 bool set_tcp_options(int file_descr, std::string &err);
 
+/*! \brief limit not sent data in tcp socket buffer (TCP_NOTSENT_LOWAT)
+ *  \param [in] file_descr - file descriptor
+ *  \param [in] bytes - socket is writable only while not sent data is less than bytes
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool set_not_sent_low_watermark(int file_descr, uint32_t bytes, std::string &err);
+
+/*! \brief cork tcp socket (TCP_CORK). Corked socket sends only full segments, uncorking sends pending tail
+ *  \param [in] file_descr - file descriptor
+ *  \param [in] enable - cork or uncork socket
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool set_tcp_cork(int file_descr, bool enable, std::string &err);
+
+/*! \brief enable sending with MSG_ZEROCOPY flag (SO_ZEROCOPY)
+ *  \param [in] file_descr - file descriptor
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool enable_zero_copy(int file_descr, std::string &err);
+
+/*! \brief enable udp generic segmentation offload (UDP_SEGMENT)
+ *  \param [in] file_descr - file descriptor
+ *  \param [in] segment_size - size of every datagram kernel will split sent data on
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool set_udp_segment_size(int file_descr, uint16_t segment_size, std::string &err);
+
+/*! \brief enable udp generic receive offload (UDP_GRO)
+ *  \param [in] file_descr - file descriptor
+ *  \param [out] err - will fill with error if something go wrong
+ *  \result true on succes. false otherwise and err will filled with error
+ */
+[[nodiscard]] bool enable_udp_gro(int file_descr, std::string &err);
+
 /*! \brief check connection established succesfully
  *  \param [in] file_descr - file descriptor
  *  \param [out] err - will fill with error if something go wrong
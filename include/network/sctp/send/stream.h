@@ -19,7 +19,7 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   ssize_t receive(std::byte *data, size_t data_size) override;
 
@@ -60,10 +60,25 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
    */
   ssize_t send_data(std::byte const *data, size_t data_size) override;
 
+  /*! \brief send data gathered from several buffers (using sctp_sendv)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   */
+  ssize_t send_data_v(iovec const *vec, size_t count) override;
+
+  /*! \brief sctp keeps message boundaries
+   *  \return true
+   */
+  bool is_message_oriented() const noexcept override { return true; }
+
   /*! \brief if connection established succesfully will prepare connection for receiving events
    *  \return true if init complete successful
    */
@@ -22,11 +22,6 @@ public:
    */
   settings const *get_settings() const override { return &_settings; }
 
-  /*! \brief get actual stream statistic
-   *  \return stream_statistic
-   */
-  statistic const *get_statistic() const override { return &_statistic; }
-
   /*!
    *  \brief init listen stream
    *  \param [in] listen_params pointer on parameters
@@ -38,11 +33,11 @@ protected:
   /*! \brief generate send sctp ssl stream
    *  \return generated send stream
    */
-  std::unique_ptr<net::stream> generate_send_stream() override;
+  send_stream_ptr generate_send_stream() override;
 
   /*! \brief fill/set send stream with specific parameters
    */
-  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) override;
+  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) override;
 
   /*! \brief cleanup/free resources
    */
@@ -52,7 +47,6 @@ private:
   SSL_CTX *_server_ctx = nullptr; ///< pointer on ssl context
   SSL *_dtls_ctx = nullptr;       ///< pointer on inited dtls context. We need this only for init dtls in ssl
   settings _settings;             ///< current settings
-  statistic _statistic;           ///< statistics
 };
 
 } // namespace bro::net::sctp::ssl::listen
@@ -26,10 +26,20 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   ssize_t receive(std::byte *data, size_t data_size) override;
 
+  /*! \brief This function receive data into several buffers (one ssl read per buffer)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes received
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or no data yet (would block)
+   */
+  ssize_t receivev(iovec *vec, size_t count) override { return strm::stream::receivev(vec, count); }
+
   /*! \brief get actual stream settings
    *  \return settings
    */
@@ -54,10 +64,20 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
    */
   ssize_t send_data(std::byte const *data, size_t data_size) override;
 
+  /*! \brief send data gathered from several buffers (one ssl write per buffer)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   */
+  ssize_t send_data_v(iovec const *vec, size_t count) override { return net::send::stream::send_data_v(vec, count); }
+
   /*! \brief cleanup/free resources
    */
   void cleanup() override;
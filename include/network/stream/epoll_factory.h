@@ -0,0 +1,175 @@
+#pragma once
+#include <stream/factory.h>
+#include <network/common/chunk_pool.h>
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace bro::net::epoll {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+class epoll_io;
+
+/**
+ * \brief stream factory (based on edge triggered epoll)
+ *
+ * File descriptor is added into epoll only once (read and write events, edge triggered) when the first io
+ * is started on it and is removed when the last io is stopped. Start/stop of read/write io only changes
+ * interest mask in user space, hence enabling/disabling write event on every partial send makes no system calls.
+ * Readiness of file descriptor is kept until stream gets EAGAIN (\ref net::io::would_block), so callbacks
+ * are called while io is ready (level triggered like libev) and idle connections cost nothing.
+ *
+ * \note streams must be destroyed before factory
+ */
+class factory : public strm::factory {
+public:
+  /*!
+   * @brief epoll instance parameters
+   */
+  struct config {
+    uint32_t _max_events = 1024; ///< max number of events got by one epoll_wait
+    chunk_pool::config _chunks;  ///< parameters of chunks pool (send buffers of bound streams)
+  };
+
+  /**
+   * \brief constructor with default config
+   */
+  factory();
+
+  /**
+   * \brief constructor
+   * \param [in] conf epoll parameters
+   *
+   * \note if epoll can't be created factory is in failed state \ref is_active
+   */
+  explicit factory(config const &conf);
+
+  /**
+   * \brief destructor. close epoll and free registrations
+   */
+  ~factory() override;
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * We can't copy and handle epoll
+   */
+  factory(factory const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Bound streams keep pointer on factory
+   */
+  factory(factory &&) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Bound streams keep pointer on factory
+   */
+  factory &operator=(factory &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * We can't copy and handle epoll
+   */
+  factory &operator=(factory const &) = delete;
+
+  /*! \brief check factory is inited
+   *  \return true if epoll is created
+   */
+  bool is_active() const noexcept { return -1 != _epoll_fd; }
+
+  /*! \brief get detailed description about error
+   *  \return error description
+   */
+  std::string const &get_error_description() const noexcept { return _err; }
+
+  /*! \brief get pool of chunks (for statistic)
+   *  \return pool of chunks
+   */
+  chunk_pool &get_chunk_pool() noexcept { return _chunks; }
+
+  /*! \brief create stream
+   *  [in] stream_set pointer on settings
+   *
+   * \note We always create stream. Even if creaion is failed.
+   * If stream created successfully we need to bind stream \ref factory::bind
+   * If something went wront we return stream with failed state and
+   * \ref stream::get_error_description can be called to get an error
+   *
+   *  \return stream_ptr created stream
+   */
+  strm::stream_ptr create_stream(strm::settings *stream_set) override;
+
+  /*! \brief bind stream
+   *  [in] stream - stream to bind
+   *
+   * \note We always need to bind created stream to factory. Only after that we start
+   * to handle all events for this stream.
+   */
+  void bind(strm::stream_ptr &stream) override;
+
+  /*! \brief proceed event loop
+   *
+   *  Get events and call stream callbacks. Never waits.
+   *  Hence we need to call it periodically
+   */
+  void proceed() override;
+
+private:
+  friend class epoll_io;
+
+  /*!
+   * \brief file descriptor added into epoll. address is user data of epoll event
+   */
+  struct registration {
+    int _fd = -1;               ///< file descriptor (-1 if removed from epoll)
+    epoll_io *_read = nullptr;  ///< started read io (nullptr if read events aren't interesting)
+    epoll_io *_write = nullptr; ///< started write io (nullptr if write events aren't interesting)
+    bool _readable = false;     ///< got read edge and stream didn't get EAGAIN after it
+    bool _writable = false;     ///< got write edge and stream didn't get EAGAIN after it
+    bool _in_ready = false;     ///< registration is in ready list
+  };
+
+  /*! \brief start io on file descriptor (add file descriptor into epoll if it isn't added yet)
+   *  \param [in] fd file descriptor
+   *  \param [in] io started io
+   *  \param [in] read read io
+   *  \return registration or nullptr if file descriptor couldn't be added into epoll
+   */
+  registration *attach(int fd, epoll_io *io, bool read);
+
+  /*! \brief stop io (remove file descriptor from epoll if there are no started io on it)
+   *  \param [in] reg registration
+   *  \param [in] read read io
+   */
+  void detach(registration *reg, bool read);
+
+  /*! \brief add registration into ready list (callbacks will be called in this/next proceed)
+   *  \param [in] reg ready registration
+   */
+  void set_ready(registration *reg);
+
+  /*! \brief call callbacks of ready io
+   *  \param [in] reg registration
+   */
+  void dispatch(registration *reg);
+
+  int _epoll_fd = -1;                         ///< epoll file descriptor
+  std::vector<epoll_event> _events;           ///< events got by epoll_wait
+  std::vector<registration *> _registrations; ///< registrations by file descriptor
+  std::vector<registration *> _ready;         ///< registrations with ready io for next dispatch
+  std::vector<registration *> _dispatching;   ///< registrations with ready io in current dispatch
+  std::vector<registration *> _released;      ///< removed registrations (lists can still point on them)
+  std::vector<registration *> _free;          ///< registrations for reuse
+  std::string _err;                           ///< error description
+  chunk_pool _chunks;                         ///< chunks for buffers of bound streams
+};
+
+} // namespace bro::net::epoll
@@ -1,14 +1,69 @@
 #pragma once
 #include <stream/factory.h>
 #include <libev_wrapper/factory.h>
+#include <network/common/chunk_pool.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+namespace bro::net {
+
+class stream_relay;
+using relay_ptr = std::unique_ptr<stream_relay>; ///< relay owned by user (see network/stream/relay.h)
+
+/*! \brief create stream for settings type (common for all factories)
+ *  [in] stream_set pointer on settings
+ *
+ *  \return stream_ptr created stream (in failed state if creation is failed). nullptr for unknown settings
+ */
+strm::stream_ptr create_stream(strm::settings *stream_set);
+
+} // namespace bro::net
 
 namespace bro::net::ev {
 /** @addtogroup network_stream
  *  @{
  */
 
+class ev_io;
+
+/**
+ * \brief statistic of factory
+ */
+struct statistic {
+  /*! \brief reset statistics
+   */
+  void reset() {
+    _events = 0;
+    _interest_updates = 0;
+    _avoided_epoll_ctl = 0;
+    _deferred_calls = 0;
+  }
+
+  /*! \brief add function
+   */
+  statistic &operator+=(statistic const &rhs) {
+    _events += rhs._events;
+    _interest_updates += rhs._interest_updates;
+    _avoided_epoll_ctl += rhs._avoided_epoll_ctl;
+    _deferred_calls += rhs._deferred_calls;
+    return *this;
+  }
+
+  uint64_t _events = 0;            ///< events of watchers passed to streams
+  uint64_t _interest_updates = 0;  ///< start/stop of watchers passed to libev (every one can be epoll_ctl)
+  uint64_t _avoided_epoll_ctl = 0; ///< restarts of watchers after poll which libev would pass to epoll_ctl
+  uint64_t _deferred_calls = 0;    ///< deferred callbacks (flushes of corked streams)
+};
+
 /**
  * \brief stream factory (based on libev)
+ *
+ * Stopping of watcher is lazy. Watcher stays in libev till its next event or till it is started again,
+ * hence disabling/enabling of write event on every partially sent message doesn't change epoll interest set.
+ * Trade-off: stopped watcher wakes reactor up once more (its event isn't passed to stream).
+ * Deferred io (corked streams) is called at the end of \ref proceed, hence every corked stream is flushed once
+ * per iteration.
  */
 class factory : public strm::factory {
 public:
@@ -17,6 +72,13 @@ public:
    */
   factory() noexcept = default;
 
+  /**
+   * \brief constructor
+   * \param [in] chunks parameters of chunks pool (send buffers of bound streams)
+   */
+  explicit factory(chunk_pool::config const &chunks) noexcept
+    : _chunks(chunks) {}
+
   /**
    * \brief disabled copy ctor
    *
@@ -67,15 +129,53 @@ public:
    */
   void bind(strm::stream_ptr &stream) override;
 
+  /*! \brief relay data between two streams (proxy)
+   *  \param [in] first first stream (bound send stream)
+   *  \param [in] second second stream (bound send stream)
+   *
+   *  \note Relay takes ownership of streams. Plain tcp streams are relayed in kernel (splice), other streams
+   *  are relayed through reactor buffer. Streams must be established before relay is started
+   *
+   *  \return relay. nullptr if streams aren't established send streams (streams aren't taken)
+   */
+  relay_ptr relay(strm::stream_ptr &&first, strm::stream_ptr &&second);
+
   /*! \brief proceed event loop
    *
    *  This function is a main funcion to generate/handle in/out events.
    *  Hence we need to call it periodically
+   *
+   *  \note deferred io is called after events. delayed io - if its delay expired
    */
   void proceed() override;
 
+  /*! \brief get statistic
+   *  \return statistic
+   */
+  statistic const &get_statistic() const noexcept { return _statistic; }
+
+  /*! \brief reset statistic
+   */
+  void reset_statistic() noexcept { _statistic.reset(); }
+
+  /*! \brief get pool of chunks (for statistic)
+   *  \return pool of chunks
+   */
+  chunk_pool &get_chunk_pool() noexcept { return _chunks; }
+
 private:
-  bro::ev::factory _factory; ///< factory for events and loop proceeding
+  friend class ev_io;
+
+  /*! \brief call deferred io and delayed io with expired delay
+   */
+  void call_deferred();
+
+  bro::ev::factory _factory;      ///< factory for events and loop proceeding
+  statistic _statistic;           ///< statistic
+  chunk_pool _chunks;             ///< chunks for buffers of bound streams
+  std::vector<ev_io *> _deferred; ///< io called at the end of iteration (nullptr - destroyed io)
+  std::vector<ev_io *> _delayed;  ///< io called after delay (nullptr - destroyed io)
+  uint64_t _iteration = 0;        ///< number of proceed calls
 };
 
 } // namespace bro::net::ev
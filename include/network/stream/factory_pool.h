@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "factory.h"
+
+namespace bro::net::ev {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief pool of reactors. Every reactor is a thread with own factory (event loop).
+ *
+ * Streams are created and bound on reactor thread, hence all stream callbacks are called on the owning reactor.
+ * Stream must be used (send/receive/destroy) only on its reactor. If we need to do something with stream from
+ * other thread, we need to pass a task to its reactor with \ref factory_pool::execute
+ *
+ * \note streams must be destroyed before pool (for instance with \ref factory_pool::execute before \ref stop)
+ */
+class factory_pool {
+public:
+  /*!
+   * @brief policy to choose reactor for new stream
+   */
+  enum class policy : uint8_t {
+    e_round_robin, ///< next reactor
+    e_hash,        ///< reactor is hash % reactors count (the same hash - the same reactor)
+    e_least_loaded ///< reactor with minimal busy time in the last measure period
+  };
+
+  using task_t = std::function<void(factory &)>; ///< task executed on reactor thread
+  using stream_created_cb
+    = std::function<void(strm::stream_ptr &&, factory &, size_t)>; ///< created stream, owning factory, reactor index
+
+  /*! \brief constructor. threads aren't started here
+   *  \param [in] reactors number of reactors (threads)
+   *  \param [in] idle_sleep sleep time if reactor had neither tasks nor events in iteration (zero - busy poll)
+   */
+  explicit factory_pool(size_t reactors, std::chrono::microseconds idle_sleep = std::chrono::microseconds(10));
+
+  /*! \brief destructor. stop and join all reactors
+   */
+  ~factory_pool();
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * We can't copy running threads
+   */
+  factory_pool(factory_pool const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Reactor threads keep pointer on pool
+   */
+  factory_pool(factory_pool &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * We can't copy running threads
+   */
+  factory_pool &operator=(factory_pool const &) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Reactor threads keep pointer on pool
+   */
+  factory_pool &operator=(factory_pool &&) = delete;
+
+  /*! \brief start reactors threads
+   *  \return false if already started
+   */
+  bool start();
+
+  /*! \brief ask all reactors to stop (doesn't wait)
+   *
+   * \note tasks passed before stop are executed before reactor thread exits
+   */
+  void stop() noexcept;
+
+  /*! \brief wait until all reactors threads are finished
+   */
+  void join();
+
+  /*! \brief check reactors are running
+   *  \return true if started and not stopped
+   */
+  bool is_running() const noexcept { return _running.load(std::memory_order_acquire); }
+
+  /*! \brief get number of reactors
+   *  \return reactors count
+   */
+  size_t size() const noexcept { return _reactors.size(); }
+
+  /*! \brief choose reactor for new stream
+   *  \param [in] pol policy
+   *  \param [in] hash hash (for instance peer address hash) used only with policy::e_hash
+   *  \return reactor index
+   */
+  size_t select_reactor(policy pol, size_t hash = 0) noexcept;
+
+  /*! \brief execute task on reactor thread
+   *  \param [in] reactor reactor index
+   *  \param [in] task task to execute
+   *
+   * \note thread safe
+   */
+  void execute(size_t reactor, task_t task);
+
+  /*! \brief create stream on one of reactors
+   *  \param [in] stream_set settings. Copied, hence can be destroyed after call
+   *  \param [in] cb callback with created stream. Called on reactor thread. Stream is already bound
+   *  if it was created successfully. Otherwise stream is in failed state (or nullptr for unknown settings)
+   *  \param [in] pol policy to choose reactor
+   *  \param [in] hash hash used only with policy::e_hash
+   *  \return reactor index which will own the stream
+   */
+  template <typename settings_t>
+  size_t create_stream(settings_t const &stream_set,
+                       stream_created_cb cb,
+                       policy pol = policy::e_round_robin,
+                       size_t hash = 0) {
+    size_t const reactor = select_reactor(pol, hash);
+    execute(reactor, [set = stream_set, cb = std::move(cb), reactor](factory &manager) mutable {
+      auto stream = manager.create_stream(&set);
+      if (stream && stream->is_active())
+        manager.bind(stream);
+      cb(std::move(stream), manager, reactor);
+    });
+    return reactor;
+  }
+
+  /*! \brief get load of reactor
+   *  \param [in] reactor reactor index
+   *  \return busy time in permille of the last measure period
+   */
+  uint32_t get_load(size_t reactor) const noexcept {
+    return _reactors[reactor]->_load.load(std::memory_order_relaxed);
+  }
+
+private:
+  /*!
+   * @brief reactor data
+   */
+  struct reactor {
+    factory _manager;                   ///< event loop
+    std::thread _thread;                ///< reactor thread
+    std::mutex _guard;                  ///< guard for tasks queue
+    std::vector<task_t> _tasks;         ///< tasks to execute on reactor
+    std::atomic_bool _has_tasks{false}; ///< fast check for new tasks
+    std::atomic<uint32_t> _load{0};     ///< busy time in permille of the last measure period
+  };
+
+  /*! \brief reactor thread main loop
+   *  \param [in] r reactor data
+   */
+  void run(reactor &r);
+
+  std::vector<std::unique_ptr<reactor>> _reactors; ///< reactors
+  std::chrono::microseconds _idle_sleep;           ///< sleep time if reactor has neither tasks nor events
+  std::atomic_bool _running{false};                ///< reactors are running
+  std::atomic<size_t> _next{0};                    ///< next reactor for round robin policy
+};
+
+} // namespace bro::net::ev
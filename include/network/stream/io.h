@@ -0,0 +1,111 @@
+#pragma once
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace bro::net {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief events source of stream. Generated by factory on bind.
+ *
+ * Readiness based io (libev, epoll) only wakes stream up and stream makes system call itself.
+ * Completion based io (io_uring) already received data/accepted connection when callback is called,
+ * hence stream must take it from io (\ref read, \ref accept) and must not use socket directly.
+ */
+class io {
+public:
+  using callback_t = std::function<void()>; ///< event callback
+
+  virtual ~io() = default;
+
+  /*! \brief start to handle events on file descriptor
+   *  \param [in] fd file descriptor
+   *  \param [in] cb callback on event
+   */
+  virtual void start(int fd, callback_t cb) = 0;
+
+  /*! \brief start to handle events on file descriptor with already set callback
+   *  \param [in] fd file descriptor
+   */
+  virtual void start(int fd) = 0;
+
+  /*! \brief stop to handle events
+   */
+  virtual void stop() = 0;
+
+  /*! \brief stop to take events, but keep already taken data (backpressure)
+   *
+   * Readiness based io doesn't take data, hence it is stopped (data stays in socket). Completion based io
+   * stops to receive new data, but data it already received is kept and is dispatched after \ref resume
+   */
+  virtual void pause() { stop(); }
+
+  /*! \brief continue to handle events after \ref pause
+   *  \param [in] fd file descriptor
+   */
+  virtual void resume(int fd) { start(fd); }
+
+  /*! \brief set callback on event
+   *  \param [in] cb callback on event
+   */
+  virtual void set_callback(callback_t cb) = 0;
+
+  /*! \brief check if io is started
+   *  \return true if started
+   */
+  virtual bool is_active() const = 0;
+
+  /*! \brief stream got EAGAIN on file descriptor (all available data is read or socket buffer is full)
+   *
+   * Edge triggered io calls callback while file descriptor is ready, hence stream needs to report that
+   * it isn't ready anymore. Level triggered and completion based io ignore it
+   */
+  virtual void would_block() noexcept {}
+
+  /*! \brief call callback once later (write io of corked stream). Repeated calls before callback aren't stacked
+   *  \param [in] fd file descriptor
+   *  \param [in] delay zero - at the end of current iteration of reactor, otherwise after delay. New delay
+   *  replaces previous one
+   *
+   *  \note \ref stop cancels call. Default implementation starts io, hence callback is called on write readiness
+   */
+  virtual void defer(int fd, std::chrono::microseconds /*delay*/) { start(fd); }
+
+  /*! \brief check if io is completion based (data is received/connections are accepted by reactor)
+   *  \return true for completion based io
+   */
+  virtual bool is_completion() const noexcept { return false; }
+
+  /*! \brief take data received by reactor (completion based io only)
+   *  \param [in] data pointer on a buffer
+   *  \param [in] data_size buffer lenght
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes copied
+   *  2. Negative - connection is closed or an error occurred (errno is set)
+   *  3. Zero - zero data_size or no data yet
+   */
+  virtual ssize_t read(std::byte * /*data*/, size_t /*data_size*/) { return 0; }
+
+  /*! \brief take data received by reactor into several buffers (completion based io only)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return the same as \ref read
+   */
+  virtual ssize_t readv(iovec * /*vec*/, size_t /*count*/) { return 0; }
+
+  /*! \brief take connection accepted by reactor (completion based io only)
+   *  \return file descriptor of accepted connection. -1 if there are no accepted connections (errno is zero)
+   *  or accept is failed (errno is set)
+   */
+  virtual int accept() { return -1; }
+};
+
+using io_ptr = std::unique_ptr<io>; ///< events source owned by stream
+
+} // namespace bro::net
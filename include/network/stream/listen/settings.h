@@ -1,4 +1,6 @@
 #pragma once
+#include <chrono>
+#include <optional>
 #include <network/stream/settings.h>
 #include <protocols/ip/full_address.h>
 #include <stream/stream.h>
@@ -17,6 +19,15 @@ struct settings : net::settings {
   in_conn_handler_cb _proc_in_conn;              ///< callback for incomming connections
   in_conn_handler_data_cb _in_conn_handler_data; ///< user data
   uint16_t _listen_backlog = 14;                 ///< listen backlog parameter
+  uint16_t _accept_budget = 64;                  ///< max connections accepted per event on listen socket
+  uint16_t _stream_pool_capacity = 128;          ///< max idle memory blocks of accepted streams (0 - pool is disabled)
+  size_t _send_high_watermark = 0;               ///< high watermark of accepted streams (see send::settings)
+  size_t _send_low_watermark = 0;                ///< low watermark of accepted streams (see send::settings)
+  std::optional<std::chrono::microseconds> _send_cork_max_delay; ///< max delay of corked accepted streams
+  size_t _send_zero_copy_threshold = 16 * 1024;  ///< zero copy threshold of accepted streams (see send::settings)
+  bool _send_cork = false;                       ///< cork mode of accepted streams (see send::settings)
+  bool _send_zero_copy = false;                  ///< zero copy mode of accepted streams (see send::settings)
+  bool _reuse_port = false;                      ///< share port with other listen streams (SO_REUSEPORT)
 };
 
 } // namespace bro::net::listen
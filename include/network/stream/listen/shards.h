@@ -0,0 +1,65 @@
+#pragma once
+#include <network/stream/factory.h>
+#include <network/stream/listen/settings.h>
+#include <network/stream/listen/statistic.h>
+#include <vector>
+
+namespace bro::net::listen {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief listen streams on the same address, one per factory (reactor).
+ *  All streams are created with SO_REUSEPORT, hence kernel balances incomming connections between them.
+ *
+ * \note streams are handled by factories threads. Statistic is read without synchronization
+ */
+class shards {
+public:
+  /*! \brief create and bind listen stream for every factory
+   *  \param [in] factories factories to bind streams (usually one per core)
+   *  \param [in] listen_set listen settings (tcp, tcp ssl, sctp, sctp ssl, udp ssl). _reuse_port will be switched on
+   *  \param [in] shard_data user data for incomming connections callback (one per factory).
+   *  If empty, _in_conn_handler_data from settings is used for all shards
+   *  \return true if all shards created. otherwise false (cause in get_error_description)
+   *
+   *  \note call before factories start proceeding in other threads
+   */
+  bool init(std::vector<ev::factory *> const &factories,
+            settings *listen_set,
+            std::vector<settings::in_conn_handler_data_cb> const &shard_data = {});
+
+  /*! \brief get number of shards
+   *  \return number of shards
+   */
+  size_t size() const noexcept { return _streams.size(); }
+
+  /*! \brief get listen stream of shard
+   *  \param [in] shard shard index
+   *  \return listen stream
+   */
+  strm::stream_ptr const &get_stream(size_t shard) const { return _streams[shard]; }
+
+  /*! \brief get accept statistic of shard
+   *  \param [in] shard shard index
+   *  \return statistic
+   */
+  statistic const &get_statistic(size_t shard) const;
+
+  /*! \brief get overall accept statistic of all shards
+   *  \return statistic
+   */
+  statistic get_statistic() const;
+
+  /*! \brief get detailed description about error
+   *  \return error description
+   */
+  std::string const &get_error_description() const noexcept { return _err; }
+
+private:
+  std::vector<strm::stream_ptr> _streams; ///< listen stream per factory
+  std::string _err;                       ///< error description ( if set error )
+};
+
+} // namespace bro::net::listen
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <chrono>
 #include <stdint.h>
 #include <stream/statistic.h>
 
@@ -16,8 +18,37 @@ struct statistic : public strm::statistic {
   void reset() override {
     _success_accept_connections = 0;
     _failed_to_accept_connections = 0;
+    _accept_events = 0;
+    _accept_budget_exhausted = 0;
+    _reused_streams = 0;
+    _reset_time = std::chrono::steady_clock::now();
   }
+
+  /*! \brief add function
+   */
+  statistic &operator+=(statistic const &rhs) {
+    _success_accept_connections += rhs._success_accept_connections;
+    _failed_to_accept_connections += rhs._failed_to_accept_connections;
+    _accept_events += rhs._accept_events;
+    _accept_budget_exhausted += rhs._accept_budget_exhausted;
+    _reused_streams += rhs._reused_streams;
+    _reset_time = std::min(_reset_time, rhs._reset_time);
+    return *this;
+  }
+
+  /*! \brief get accept rate since creation/last reset
+   *  \return accepted connections per second
+   */
+  double get_accept_rate() const noexcept {
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - _reset_time;
+    return elapsed.count() > 0 ? _success_accept_connections / elapsed.count() : 0;
+  }
+
   uint64_t _success_accept_connections = 0;   ///< accepted connection. fully created streams
   uint64_t _failed_to_accept_connections = 0; ///< fail to accept connection. reason in stream::get_error_description
+  uint64_t _accept_events = 0;                ///< handled events on listen socket (accepted per event = success / events)
+  uint64_t _accept_budget_exhausted = 0;      ///< events stopped by accept budget (backlog may still have connections)
+  uint64_t _reused_streams = 0;               ///< accepted streams constructed in memory of destroyed ones
+  std::chrono::steady_clock::time_point _reset_time = std::chrono::steady_clock::now(); ///< creation/last reset time
 };
 } // namespace bro::net::listen
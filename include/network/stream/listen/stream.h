@@ -1,7 +1,10 @@
 #pragma once
-#include <libev_wrapper/io.h>
 #include <network/platforms/system.h>
+#include <network/stream/io.h>
 #include <network/stream/stream.h>
+#include <network/stream/listen/settings.h>
+#include <network/stream/listen/stream_pool.h>
+#include <new>
 
 #include "statistic.h"
 
@@ -17,6 +20,8 @@ namespace bro::net::listen {
  */
 class stream : public net::stream {
 public:
+  using send_stream_ptr = std::unique_ptr<net::stream, strm::stream_deleter>; ///< accepted stream
+
   ~stream();
 
   /*! \brief do nothing here
@@ -66,30 +71,73 @@ public:
   /*! \brief assign event loop to current stream
    *  \param [in] in_conn pointer on loop
    */
-  void assign_event(bro::ev::io_t &&in_conn);
+  void assign_event(net::io_ptr &&in_conn);
+
+  /*! \brief check stream can take connections accepted by reactor (completion based factory)
+   *  \return true if connections are accepted only in \ref handle_incoming_connection
+   *
+   *  \note otherwise factory generates readiness based event
+   */
+  virtual bool is_accept_by_reactor_supported() const noexcept { return true; }
 
 protected:
   /*! \brief generate send stream of specific type
    *  \return generated send stream
    */
-  virtual std::unique_ptr<net::stream> generate_send_stream() = 0;
+  virtual send_stream_ptr generate_send_stream() = 0;
 
-  /*! \brief process new incomming connection
+  /*! \brief construct send stream in memory of streams pool (\ref settings::_stream_pool_capacity)
+   *  \return constructed stream. deleter returns it into pool
+   */
+  template <typename T> std::unique_ptr<T, strm::stream_deleter> make_send_stream() {
+    if (!_streams) {
+      auto const capacity = ((listen::settings const *) get_settings())->_stream_pool_capacity;
+      if (0 == capacity)
+        return std::make_unique<T>();
+      _streams = new stream_pool(sizeof(T), capacity);
+    }
+    if (sizeof(T) > _streams->get_object_size())
+      return std::make_unique<T>();
+    bool reused{false};
+    void *block = _streams->acquire(reused);
+    if (reused)
+      ++_statistic._reused_streams;
+    T *st{nullptr};
+    try {
+      st = new (block) T();
+    } catch (...) {
+      // stream isn't constructed, hence deleter can't be used
+      _streams->release(block);
+      throw;
+    }
+    return std::unique_ptr<T, strm::stream_deleter>(st, _streams->get_deleter());
+  }
+
+  /*! \brief process new incomming connections (no more than accept budget per event)
    */
   virtual void handle_incoming_connection();
 
   /*! \brief fill/set send stream with specific parameters
    */
-  [[nodiscard]] virtual bool fill_send_stream(accept_connection_res const &result,
-                                              std::unique_ptr<net::stream> &new_stream);
+  [[nodiscard]] virtual bool fill_send_stream(accept_connection_res const &result, send_stream_ptr &new_stream);
+
+  /*! \brief there are no pending connections (reactor waits next connection event)
+   */
+  void accept_would_block() noexcept {
+    if (_in_connections)
+      _in_connections->would_block();
+  }
 
   /*! \brief cleanup/free resources
    */
   void cleanup() override;
 
 private:
-  statistic _statistic;          ///< statistics
-  bro::ev::io_t _in_connections; ///< wait connection event
+  statistic _statistic;            ///< statistics
+  net::io_ptr _in_connections;     ///< wait connection event
+  stream_pool *_streams = nullptr; ///< memory of accepted streams (lazy created)
+  send_stream_ptr _accept_stream;  ///< stream for next accepted connection
+  bool *_destroyed = nullptr;      ///< set if stream is destroyed by incoming connection callback
 };
 
 } // namespace bro::net::listen
@@ -0,0 +1,103 @@
+#pragma once
+#include <stream/stream.h>
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+
+namespace bro::net::listen {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief pool of memory for accepted streams
+ *
+ * Accepted stream is constructed in memory taken from pool and \ref strm::stream_deleter returns memory
+ * into free list after stream is destroyed (socket is closed, buffers are released), hence next accepted
+ * stream is constructed in the same place without heap allocation.
+ * Pool is owned by listen stream, but accepted streams can outlive it. Pool is freed with last of them.
+ *
+ * \note pool itself is thread safe, but accepted streams must be destroyed on the reactor which owns them
+ * (their buffers return chunks into chunk pool of that factory, see also \ref ev::factory_pool)
+ */
+class stream_pool {
+public:
+  /*! \brief constructor
+   *  \param [in] object_size size of memory for one stream
+   *  \param [in] max_idle max number of free memory blocks kept in pool
+   */
+  stream_pool(size_t object_size, size_t max_idle);
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * Deleters keep pointer on pool
+   */
+  stream_pool(stream_pool const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Deleters keep pointer on pool
+   */
+  stream_pool(stream_pool &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * Deleters keep pointer on pool
+   */
+  stream_pool &operator=(stream_pool const &) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Deleters keep pointer on pool
+   */
+  stream_pool &operator=(stream_pool &&) = delete;
+
+  /*! \brief get size of memory for one stream
+   *  \return size of memory block
+   */
+  size_t get_object_size() const noexcept { return _object_size; }
+
+  /*! \brief borrow memory for stream
+   *  \param [out] reused memory is taken from free list
+   *  \return memory block (throws std::bad_alloc if memory couldn't be allocated)
+   */
+  void *acquire(bool &reused);
+
+  /*! \brief return memory which wasn't used for stream (stream constructor failed)
+   *  \param [in] block memory block taken with \ref acquire
+   */
+  void release(void *block) noexcept;
+
+  /*! \brief get deleter which returns stream into this pool
+   *  \return deleter
+   */
+  strm::stream_deleter get_deleter() noexcept { return {&stream_pool::recycle, this}; }
+
+  /*! \brief owner is destroyed. free idle memory, pool is deleted when last stream is returned
+   */
+  void detach() noexcept;
+
+private:
+  /*! \brief destructor. free idle memory
+   */
+  ~stream_pool();
+
+  /*! \brief destroy stream and return its memory into pool
+   *  \param [in] pool pointer on pool
+   *  \param [in] st stream constructed in memory of pool
+   */
+  static void recycle(void *pool, strm::stream *st) noexcept;
+
+  std::mutex _guard;         ///< guard (pool is shared by listen stream and accepted streams of all reactors)
+  std::vector<void *> _idle; ///< free memory blocks
+  size_t _object_size;       ///< size of memory block
+  size_t _max_idle;          ///< max number of free memory blocks
+  size_t _borrowed = 0;      ///< number of alive streams
+  bool _detached = false;    ///< owner is destroyed
+};
+
+} // namespace bro::net::listen
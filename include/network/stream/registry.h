@@ -0,0 +1,86 @@
+#pragma once
+#include <network/stream/listen/stream.h>
+#include <network/stream/send/stream.h>
+#include <stream/settings.h>
+#include <stream/stream.h>
+#include <stdint.h>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+
+namespace bro::net {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/*! \brief kind of stream. factories assign events by kind
+ */
+enum class stream_kind : uint8_t {
+  e_unknown, ///< not a network stream
+  e_send,    ///< \ref send::stream
+  e_listen   ///< \ref listen::stream
+};
+
+using stream_creator = strm::stream_ptr (*)(strm::settings *stream_set); ///< create and init stream for settings
+using settings_matcher = bool (*)(strm::settings const *stream_set);    ///< check settings are derived from type
+
+/*! \brief create stream of type and init it with settings
+ *  \param [in] stream_set pointer on settings (must be Settings)
+ *  \return created stream
+ */
+template <typename Settings, typename Stream> strm::stream_ptr create_stream_of_type(strm::settings *stream_set) {
+  auto sck = std::make_unique<Stream>();
+  sck->init(static_cast<Settings *>(stream_set));
+  return sck;
+}
+
+/*! \brief check settings are Settings or derived from them
+ *  \param [in] stream_set pointer on settings
+ *  \return true if settings are Settings
+ */
+template <typename Settings> bool is_settings_of_type(strm::settings const *stream_set) {
+  return nullptr != dynamic_cast<Settings const *>(stream_set);
+}
+
+/*! \brief get kind of stream type
+ *  \return kind of stream
+ */
+template <typename Stream> constexpr stream_kind stream_kind_of() {
+  static_assert(std::is_base_of_v<send::stream, Stream> || std::is_base_of_v<listen::stream, Stream>,
+                "stream must be send or listen stream");
+  return std::is_base_of_v<send::stream, Stream> ? stream_kind::e_send : stream_kind::e_listen;
+}
+
+/*! \brief register stream type for settings type
+ *  \param [in] settings_type type of settings
+ *  \param [in] creator function which creates stream
+ *  \param [in] matcher function which checks that settings are derived from settings_type
+ *  \param [in] kind kind of created stream
+ *
+ *  \note Built-in streams are registered already. Registration replaces previous stream type for the same
+ *  settings type. It isn't thread safe, hence types must be registered before streams are created.
+ *  \ref create_stream finds stream by exact type of settings with one lookup. Settings derived from
+ *  registered type (but not registered itself) are checked by matchers one by one
+ */
+void register_stream_type(std::type_index settings_type, stream_creator creator, settings_matcher matcher,
+                          stream_kind kind);
+
+/*! \brief register stream type for settings type
+ *
+ *  \code
+ *     net::register_stream_type<my::settings, my::stream>();
+ *     auto st = factory.create_stream(&my_settings); // my::stream inited with my_settings
+ *  \endcode
+ */
+template <typename Settings, typename Stream> void register_stream_type() {
+  register_stream_type(typeid(Settings), &create_stream_of_type<Settings, Stream>, &is_settings_of_type<Settings>,
+                       stream_kind_of<Stream>());
+}
+
+/*! \brief get kind of stream (by type of its settings)
+ *  \param [in] stream pointer on stream
+ *  \return kind of stream
+ */
+stream_kind get_stream_kind(strm::stream const *stream);
+
+} // namespace bro::net
@@ -0,0 +1,232 @@
+#pragma once
+#include <network/stream/send/stream.h>
+#include <stream/stream.h>
+#include <stdint.h>
+#include <any>
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace bro::net {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief statistic of relay
+ */
+struct relay_statistic {
+  /*! \brief reset statistics
+   */
+  void reset() {
+    _first_to_second = 0;
+    _second_to_first = 0;
+  }
+
+  /*! \brief add function
+   */
+  relay_statistic &operator+=(relay_statistic const &rhs) {
+    _first_to_second += rhs._first_to_second;
+    _second_to_first += rhs._second_to_first;
+    return *this;
+  }
+
+  uint64_t _first_to_second = 0; ///< bytes relayed from first stream to second
+  uint64_t _second_to_first = 0; ///< bytes relayed from second stream to first
+};
+
+/**
+ * \brief relay of data between two send streams (proxy)
+ *
+ * Plain tcp streams (read by readiness events) are relayed in kernel - data is moved from socket into pipe
+ * and from pipe into other socket with splice. Other streams (ssl, datagrams, streams read by reactor) are
+ * relayed with receive into reactor buffer and send (not sent data is kept in send buffer of stream).
+ * Reading of stream pauses while other stream doesn't accept data and resumes when it is drained.
+ * Connection closed by peer is half closed on other side (shutdown) after all its data is delivered,
+ * data of other direction is still relayed. Plain tcp streams are half closed, ssl streams and failed
+ * streams finish both directions.
+ *
+ * \note relay owns streams. Streams must be established and bound to one factory
+ */
+class stream_relay {
+public:
+  using finished_cb = std::function<void(stream_relay *, std::any)>; ///< callback on finished relay
+
+  /*! \brief constructor. starts relay
+   *  \param [in] first first stream
+   *  \param [in] second second stream
+   */
+  stream_relay(std::unique_ptr<send::stream, strm::stream_deleter> &&first,
+               std::unique_ptr<send::stream, strm::stream_deleter> &&second);
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * Callbacks of streams keep pointer on relay
+   */
+  stream_relay(stream_relay const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Callbacks of streams keep pointer on relay
+   */
+  stream_relay(stream_relay &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * Callbacks of streams keep pointer on relay
+   */
+  stream_relay &operator=(stream_relay const &) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Callbacks of streams keep pointer on relay
+   */
+  stream_relay &operator=(stream_relay &&) = delete;
+
+  /*! \brief destructor. closes streams
+   */
+  ~stream_relay();
+
+  /*! \brief set callback on finished relay (both directions are closed or an error occurred)
+   *  \param [in] cb callback function. relay must not be destroyed in callback
+   *  \param [in] param parameter for callback function
+   */
+  void set_finished_cb(finished_cb cb, std::any param);
+
+  /*! \brief check relay is finished
+   *  \return true if both directions are closed or an error occurred
+   */
+  bool is_finished() const noexcept { return _finished; }
+
+  /*! \brief check data is relayed in kernel (splice)
+   *  \return true if data doesn't pass user space
+   */
+  bool is_spliced() const noexcept { return _spliced; }
+
+  /*! \brief get detailed description about error
+   *  \return error description (empty if relay wasn't failed)
+   */
+  std::string const &get_error_description() const noexcept { return _err; }
+
+  /*! \brief get statistic
+   *  \return statistic
+   */
+  relay_statistic const &get_statistic() const noexcept { return _statistic; }
+
+  /*! \brief get first stream
+   *  \return first stream
+   */
+  send::stream *get_first() const noexcept { return _first.get(); }
+
+  /*! \brief get second stream
+   *  \return second stream
+   */
+  send::stream *get_second() const noexcept { return _second.get(); }
+
+private:
+  /**
+   * \brief one direction of relay
+   */
+  struct direction {
+    send::stream *_from = nullptr;    ///< stream data is read from
+    send::stream *_to = nullptr;      ///< stream data is sent to
+    uint64_t *_bytes = nullptr;       ///< counter of relayed bytes
+    std::array<int, 2> _pipe{-1, -1}; ///< pipe (splice). read and write ends
+    size_t _in_pipe = 0;              ///< bytes in pipe
+    bool _eof = false;                ///< stream data is read from is closed
+    bool _done = false;               ///< all data is delivered (other side is half closed)
+  };
+
+  /*! \brief check stream can be relayed with splice
+   *  \param [in] st stream
+   *  \return true for plain tcp stream read by readiness events
+   */
+  static bool is_splice_supported(send::stream *st) noexcept;
+
+  /*! \brief prepare direction and start to read data
+   *  \param [in] dir direction
+   *  \return false if pipe couldn't be created
+   */
+  bool start(direction &dir);
+
+  /*! \brief data can be read (splice)
+   *  \param [in] dir direction
+   */
+  void splice_readable(direction &dir);
+
+  /*! \brief stream data is sent to is writable (splice)
+   *  \param [in] dir direction
+   */
+  void splice_writable(direction &dir);
+
+  /*! \brief move data from pipe into stream data is sent to
+   *  \param [in] dir direction
+   *  \return false on error (relay is finished)
+   */
+  bool flush_pipe(direction &dir);
+
+  /*! \brief data can be read (copy)
+   *  \param [in] dir direction
+   */
+  void copy_readable(direction &dir);
+
+  /*! \brief send buffer of stream data is sent to is drained (copy)
+   *  \param [in] dir direction
+   */
+  void copy_drained(direction &dir);
+
+  /*! \brief stream data is read from is closed by peer, but it can still send (copy)
+   *  \param [in] dir direction
+   */
+  void peer_closed(direction &dir);
+
+  /*! \brief get description of failed send
+   *  \param [in] st stream data is sent to
+   *  \return error description
+   */
+  static std::string get_send_error(send::stream *st);
+
+  /*! \brief stream data is read from is closed (failed or closed by peer without half close)
+   *  \param [in] dir direction
+   */
+  void stream_closed(direction &dir);
+
+  /*! \brief all data of direction is delivered. half close other side
+   *  \param [in] dir direction
+   *
+   *  \note can call finished callback
+   */
+  void close_direction(direction &dir);
+
+  /*! \brief stop relay with error
+   *  \param [in] err error description
+   *
+   *  \note calls finished callback
+   */
+  void fail(std::string const &err);
+
+  /*! \brief stop events and call finished callback
+   */
+  void finish();
+
+  std::unique_ptr<send::stream, strm::stream_deleter> _first;  ///< first stream
+  std::unique_ptr<send::stream, strm::stream_deleter> _second; ///< second stream
+  direction _forward;                                          ///< from first stream to second
+  direction _backward;                                         ///< from second stream to first
+  relay_statistic _statistic;                                  ///< statistic
+  finished_cb _finished_cb;                                    ///< finished callback
+  std::any _param_finished_cb;                                 ///< user data for finished callback
+  std::string _err;                                            ///< error description
+  send::stream *_sending_to = nullptr;                         ///< stream relayed data is sent to now (its failure is error)
+  bool _spliced = false;                                       ///< data is relayed with splice
+  bool _finished = false;                                      ///< relay is finished
+};
+
+using relay_ptr = std::unique_ptr<stream_relay>; ///< relay owned by user
+
+} // namespace bro::net
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <optional>
 #include <network/stream/settings.h>
 #include <protocols/ip/full_address.h>
@@ -15,6 +16,20 @@ struct settings : net::settings {
   std::optional<proto::ip::full_address> _self_addr; ///< self address
   bool _buffer_send{true}; ///< if couldn't send all with one send call, will buffer and send parts.
                            ///< If it fallse caller must check return size carefully ( actual for extenal buffer >
+  bool _zero_copy{false}; ///< send data with MSG_ZEROCOPY (tcp/udp). User buffer must stay valid until completion
+                          ///< notification (see stream::set_zero_copy_completed_cb)
+  size_t _zero_copy_threshold{16 * 1024}; ///< sends smaller than threshold are copied as usual
+  size_t _receive_buffer_size{64 * 1024}; ///< size of read in received view mode (see stream::set_received_view_cb)
+  size_t _max_unconsumed_size{1024 * 1024}; ///< stream fails if data not consumed by received view callback grows
+                                            ///< above it (0 - not limited)
+  size_t _high_watermark{0}; ///< send returns send_queue_full if buffered data would grow above it (0 - not limited)
+                             ///< (see stream::is_send_queue_full)
+  size_t _low_watermark{0};  ///< send queue drained callback is called when buffered data falls to it
+                             ///< (see stream::set_send_queue_drained_cb)
+  bool _cork{false}; ///< send only appends data to send buffer. buffer is flushed with one write at the end of
+                     ///< reactor iteration (ev factory. other factories flush it on write event)
+  std::optional<std::chrono::microseconds> _cork_max_delay; ///< corked tcp socket (TCP_CORK) sends only full segments.
+                                                            ///< Tail is sent when stream is idle for this delay
 };
 
 } // namespace bro::net::send
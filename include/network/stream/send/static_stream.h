@@ -0,0 +1,67 @@
+#pragma once
+#include <network/stream/send/stream.h>
+#include <type_traits>
+
+namespace bro::net::send {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+/**
+ * \brief send stream with protocol chosen at compile time
+ *
+ * Final class over protocol stream (\ref tcp::send::stream, \ref udp::send::stream, ssl streams).
+ * Calls through pointer on static_stream are resolved at compile time and send path calls send_data of
+ * protocol directly (common part is \ref send::stream::send_user_data template), hence data path has no
+ * virtual calls and compiler can inline it. It is still strm::stream - it is bound to factory and
+ * has the same callbacks as polymorphic stream
+ *
+ * \code
+ *   auto sck = std::make_unique<tcp::send::static_stream>();
+ *   sck->init(&settings);
+ *   auto *fast = sck.get();
+ *   strm::stream_ptr st = std::move(sck);
+ *   factory.bind(st);
+ *   fast->send(data, size); // no virtual calls
+ * \endcode
+ */
+template <typename Protocol> class static_stream final : public Protocol {
+  static_assert(std::is_base_of_v<send::stream, Protocol>, "protocol must be send stream");
+
+public:
+  /*! \brief This function sends the specified data (protocol is called directly)
+   *  \param [in] data pointer on a data to send
+   *  \param [in] data_size data lenght
+   *  \return the same as \ref send::stream::send
+   */
+  ssize_t send(std::byte const *data, size_t data_size) override {
+    iovec const vec{const_cast<std::byte *>(data), data_size};
+    return this->send_user_data(&vec, 1, data_size, [&]() { return Protocol::send_data(data, data_size); });
+  }
+
+  /*! \brief This function sends data gathered from several buffers (protocol is called directly)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return the same as \ref send::stream::sendv
+   */
+  ssize_t sendv(iovec const *vec, size_t count) override {
+    return this->send_user_data(vec, count, strm::get_iovec_size(vec, count),
+                                [&]() { return Protocol::send_data_v(vec, count); });
+  }
+
+  /*! \brief This function receive data (protocol is called directly)
+   *  \param [in] data pointer on a buffer
+   *  \param [in] data_size buffer lenght
+   *  \return the same as protocol receive
+   */
+  ssize_t receive(std::byte *data, size_t data_size) override { return Protocol::receive(data, data_size); }
+
+  /*! \brief This function receive data into several buffers (protocol is called directly)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return the same as protocol receivev
+   */
+  ssize_t receivev(iovec *vec, size_t count) override { return Protocol::receivev(vec, count); }
+};
+
+} // namespace bro::net::send
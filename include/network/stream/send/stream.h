@@ -1,17 +1,43 @@
 #pragma once
-#include <libev_wrapper/io.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
 #include <network/common/buffer.h>
+#include <network/common/chunk_pool.h>
+#include <network/stream/io.h>
 #include <network/stream/stream.h>
 
 namespace bro::net::listen {
 class stream;
 } // namespace bro::net::listen
 
+namespace bro::net {
+class stream_relay;
+} // namespace bro::net
+
 namespace bro::net::send {
 /** @addtogroup network_stream
  *  @{
  */
 
+/*!
+ * \brief callback on completed zero copy sends. [first id, last id] - range of completed sends
+ */
+using zero_copy_completed_cb = std::function<void(strm::stream *, uint32_t, uint32_t, std::any)>;
+
+/*!
+ * \brief callback on data read by library. returns number of consumed bytes.
+ * Not consumed bytes stay in stream and are passed again (with next received data) in the next call
+ */
+using received_view_cb = std::function<size_t(strm::stream *, std::byte const *, size_t, std::any)>;
+
+/*!
+ * \brief result of send when data is refused by high watermark (data isn't taken, stream stays active)
+ */
+inline constexpr ssize_t send_queue_full = -2;
+
 /**
  * \brief send stream
  */
@@ -24,13 +50,45 @@ public:
    *  \param [in] data_size data lenght
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
-   *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  2. Negative - an error occurred. \ref send_queue_full if send buffer is above high watermark
+   *  (\ref is_send_queue_full) - data isn't taken, stream stays active
+   *  3. Zero - zero data_size or socket buffer is full and send bufferization is switched off
    *
-   *  \note in send we use bufferization, hence we can't send half data
+   *  \note in send we use bufferization, hence we can't send half data. In cork mode (\ref settings::_cork) data
+   *  is always buffered and sent by reactor
    */
   ssize_t send(std::byte const *data, size_t data_size) override;
 
+  /*! \brief This function sends data gathered from several buffers
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred. \ref send_queue_full if send buffer is above high watermark
+   *  (\ref is_send_queue_full) - data isn't taken, stream stays active
+   *  3. Zero - zero overall size or socket buffer is full and send bufferization is switched off
+   *
+   *  \note in send we use bufferization, hence we can't send half data.
+   *  Unsent tail is appended to the send buffer buffer by buffer
+   */
+  ssize_t sendv(iovec const *vec, size_t count) override;
+
+  /*! \brief This function sends part of file (without copy into user space if protocol supports it)
+   *  \param [in] file_fd file descriptor of file
+   *  \param [in] offset offset of first byte in file
+   *  \param [in] size number of bytes to send
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent (or queued)
+   *  2. Negative - an error occurred or protocol keeps message boundaries (stream isn't changed).
+   *  \ref send_queue_full if send queue is above high watermark - file isn't queued, stream stays active
+   *  3. Zero - zero size or socket buffer is full and send bufferization is switched off
+   *
+   *  \note not sent part of file is queued after already buffered data and is sent on write event. Data
+   *  sent after it is queued after file, hence files and buffers are sent in order. Queued file part keeps
+   *  duplicate of descriptor, hence caller can close file right after call
+   */
+  ssize_t send_file(int file_fd, off_t offset, size_t size);
+
   /*! \brief set callback on data receive
    *  \param [in] cb pointer on callback function. If we send
    * nullptr, we switch off handling this type of events
@@ -44,6 +102,76 @@ public:
    */
   void set_send_data_cb(strm::received_data_cb cb, std::any param) override;
 
+  /*! \brief set handler of events
+   *  \param [in] handler pointer on handler. nullptr switches off handler
+   *  \param [in] writable_events call \ref strm::stream_handler::on_writable on every write event
+   *  (replaces sending of buffered data like \ref set_send_data_cb, stream must be bound). Buffered data is
+   *  sent on write event again when handler is removed or set without writable events
+   *
+   *  \note handler is called instead of received data callback (including view mode)
+   */
+  void set_handler(strm::stream_handler *handler, bool writable_events) override;
+
+  /*! \brief set callback on drained send buffer
+   *  \param [in] cb callback function. nullptr switches off callback
+   *  \param [in] param parameter for callback function
+   *
+   *  \note callback is called once after send was refused by high watermark, when buffered data
+   *  falls to low watermark (\ref settings::_low_watermark)
+   */
+  void set_send_queue_drained_cb(strm::send_data_cb cb, std::any param);
+
+  /*! \brief check send was refused because send buffer is above high watermark
+   *  \return true until buffered data falls to low watermark
+   */
+  bool is_send_queue_full() const noexcept { return _send_queue_full; }
+
+  /*! \brief get size of not sent data
+   *  \return size of send buffer and of queued file parts
+   */
+  size_t get_send_queue_size() const noexcept { return _send_buffer.size() + _queued_file_size; }
+
+  /*! \brief set callback on completed zero copy sends
+   *  \param [in] cb callback function.
+   *  \param [in] param parameter for callback function
+   *
+   *  \note after completion kernel doesn't use user buffer anymore. Ids are the same as
+   *  \ref get_last_zero_copy_id returns after send
+   */
+  void set_zero_copy_completed_cb(zero_copy_completed_cb cb, std::any param);
+
+  /*! \brief set callback on data read by library
+   *  \param [in] cb callback function. nullptr switches off this mode
+   *  \param [in] param parameter for callback function
+   *
+   *  \note replaces callback set by set_received_data_cb. On every read event stream reads data into
+   *  reactor (thread) buffer until socket is empty and passes it to callback, hence callback must not call
+   *  receive itself. Data is valid only inside callback. For datagram protocols every callback gets one
+   *  datagram and not consumed part of datagram is dropped. Stream fails if not consumed data grows above
+   *  \ref settings::_max_unconsumed_size
+   */
+  void set_received_view_cb(received_view_cb cb, std::any param);
+
+  /*! \brief get size of received data which wasn't consumed by \ref received_view_cb
+   *  \return size of buffered data
+   */
+  size_t get_unconsumed_size() const noexcept { return _unconsumed.size(); }
+
+  /*! \brief get id of last send call if data was sent with MSG_ZEROCOPY
+   *  \return id of zero copy send, nullopt if last send copied data (or buffered it)
+   *
+   *  \note buffer passed to this send must stay valid until \ref zero_copy_completed_cb with this id
+   */
+  std::optional<uint32_t> get_last_zero_copy_id() const noexcept { return _last_zero_copy_id; }
+
+  /*! \brief get self address of connection
+   *  \return self address, nullopt if socket isn't bound yet
+   *
+   *  \note accepted connections with wildcard listen address don't request self address on accept.
+   *  It is requested from socket on first call
+   */
+  std::optional<proto::ip::full_address> const &get_self_address() const;
+
   /*! brief check if stream in active state
    *  \return bool
    */
@@ -54,7 +182,24 @@ public:
    *  \param [in] read event controller
    *  \param [in] write event controller
    */
-  void assign_events(bro::ev::io_t &&read, bro::ev::io_t &&write);
+  void assign_events(net::io_ptr &&read, net::io_ptr &&write);
+
+  /*! \brief borrow chunks of send buffer and not consumed received data from pool of reactor
+   *  \param [in] pool pool of chunks (must outlive stream)
+   */
+  void set_chunk_pool(chunk_pool *pool);
+
+  /*! \brief check stream can take data received by reactor (completion based factory)
+   *  \return true if stream reads data only with \ref receive/\ref receivev
+   *
+   *  \note otherwise factory generates readiness based read event
+   */
+  virtual bool is_receive_by_reactor_supported() const noexcept { return false; }
+
+  /*! \brief check data of stream can be moved in kernel with splice (\ref stream_relay)
+   *  \return true if socket carries user data as is
+   */
+  virtual bool is_splice_supported() const noexcept { return false; }
 
 protected:
   /*! \brief send data using underlying protocol
@@ -63,15 +208,61 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
+   *
+   *  \note must not wait for socket. On would block unsent data will be buffered and sent on write event
    */
   virtual ssize_t send_data(std::byte const *data, size_t data_size) = 0;
 
+  /*! \brief send data gathered from several buffers using underlying protocol
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   *
+   *  \note default implementation calls \ref send_data for every buffer
+   */
+  virtual ssize_t send_data_v(iovec const *vec, size_t count);
+
   /*! \brief if connection established succesfully will prepare connection for receiving events
    *  \return true if init complete successful
    */
   virtual bool connection_established();
 
+  /*! \brief send part of file using underlying protocol
+   *  \param [in] file_fd file descriptor of file
+   *  \param [in] offset offset of first byte in file
+   *  \param [in] size number of bytes to send
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred (or file is shorter than requested)
+   *  3. Zero - zero size or socket buffer is full (would block)
+   *
+   *  \note default implementation reads file into reactor buffer and sends it with \ref send_data
+   */
+  virtual ssize_t send_file_data(int file_fd, off_t offset, size_t size);
+
+  /*! \brief cork socket (kernel sends only full segments till socket is uncorked)
+   *  \param [in] enable cork or uncork socket
+   *  \return true if socket is corked/uncorked. false if protocol doesn't support it
+   */
+  virtual bool cork_socket(bool /*enable*/) { return false; }
+
+  /*! \brief check protocol keeps message boundaries (datagrams)
+   *  \return true if every send call is a separate message
+   *
+   *  \note buffered messages are sent one by one with the same boundaries
+   */
+  virtual bool is_message_oriented() const noexcept { return false; }
+
+  /*! \brief get min size of next write. protocol can require to retry unfinished write with at least the same
+   *  amount of data (ssl record is already made), while buffered data can be split on shorter segments
+   *  \return size of unfinished write (0 - any size)
+   */
+  virtual size_t get_retry_write_size() const noexcept { return 0; }
+
   /*!
    *  \brief cleanup/free resources (except error message)
    */
@@ -87,7 +278,163 @@ protected:
    */
   void enable_send_cb();
 
+  /*!
+   *  \brief get flag for send call (MSG_ZEROCOPY if we can send user data without copy)
+   *  \param [in] data_size size of data to send
+   *  \return MSG_ZEROCOPY or 0
+   */
+  int get_zero_copy_flag(size_t data_size) const noexcept {
+    return _sending_user_data && _zero_copy_threshold && data_size >= *_zero_copy_threshold ? MSG_ZEROCOPY : 0;
+  }
+
+  /*!
+   *  \brief check data is received by reactor (read event is completion based)
+   *  \return true if data must be taken with \ref read_received
+   */
+  bool is_received_by_reactor() const noexcept { return _read && _read->is_completion(); }
+
+  /*! \brief all available data is read from socket (reactor waits next read event)
+   */
+  void receive_would_block() noexcept {
+    if (_read)
+      _read->would_block();
+  }
+
+  /*! \brief connection is closed by peer
+   *  \return true if stream stays open to send (receive returns 0, read events are stopped),
+   *  false if stream must be failed as usual
+   */
+  bool peer_closed() noexcept {
+    if (!_keep_open_on_eof)
+      return false;
+    _peer_closed = true;
+    if (_read)
+      _read->stop();
+    return true;
+  }
+
+  /*! \brief socket buffer is full (reactor waits next write event)
+   */
+  void send_would_block() noexcept {
+    if (_write)
+      _write->would_block();
+  }
+
+  /*! \brief take data received by reactor
+   *  \param [in] data pointer on a buffer
+   *  \param [in] data_size buffer lenght
+   *  \return the same as \ref net::io::read
+   */
+  ssize_t read_received(std::byte *data, size_t data_size) { return _read->read(data, data_size); }
+
+  /*! \brief take data received by reactor into several buffers
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return the same as \ref net::io::read
+   */
+  ssize_t read_received_v(iovec *vec, size_t count) { return _read->readv(vec, count); }
+
+  /*! \brief send user data (common part of \ref send, \ref sendv and \ref static_stream)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \param [in] data_size overall size of buffers
+   *  \param [in] send_fn function which sends buffers using underlying protocol (\ref send_data/\ref send_data_v)
+   *  \return the same as \ref send
+   *
+   *  \note template, hence static streams call protocol without virtual call and it can be inlined
+   */
+  template <typename SendFn>
+  ssize_t send_user_data(iovec const *vec, size_t count, size_t data_size, SendFn &&send_fn) {
+    _last_zero_copy_id.reset();
+    // check stream state (state isn't overridden by protocols, hence no virtual call)
+    switch (net::stream::get_state()) {
+    case state::e_established:
+      break;
+    case state::e_wait: {
+      if (!_buffer_send)
+        return 0;
+      if (is_over_high_watermark(data_size))
+        return send_queue_full;
+      buffer_message(vec, count, 0);
+      return data_size;
+    }
+    case state::e_failed:
+      [[fallthrough]];
+    case state::e_closed: {
+      return -1;
+    }
+    default:
+      break;
+    }
+
+    // check buffer is not empty
+    if (!is_send_queue_empty()) {
+      if (is_over_high_watermark(data_size))
+        return send_queue_full;
+      buffer_message(vec, count, 0);
+      return data_size;
+    }
+
+    if (_cork) {
+      // all sends of reactor iteration are flushed with one write
+      buffer_message(vec, count, 0);
+      _write->defer(get_fd(), {});
+      return data_size;
+    }
+
+    _sending_user_data = true;
+    ssize_t sent = send_fn();
+    _sending_user_data = false;
+    if (!_buffer_send)
+      return sent;
+    if (sent >= 0 && (size_t) sent != data_size) {
+      // socket buffer is full. send rest on write event
+      buffer_message(vec, count, sent);
+      enable_send_cb();
+      return data_size;
+    }
+    return sent;
+  }
+
+  /*! \brief check nothing is waiting for send
+   *  \return true if send buffer is empty and there are no queued files
+   */
+  bool is_send_queue_empty() const noexcept { return _send_buffer.is_empty() && _files.empty(); }
+
+  /*! \brief check data can't be buffered (buffered data would grow above high watermark)
+   *  \param [in] data_size size of data to buffer
+   *  \return true if data must be refused
+   *
+   *  \note the first message is always buffered, hence message bigger than high watermark can be sent
+   */
+  bool is_over_high_watermark(size_t data_size) noexcept {
+    if (!_high_watermark || is_send_queue_empty() || get_send_queue_size() + data_size <= _high_watermark)
+      return false;
+    _send_queue_full = true;
+    return true;
+  }
+
+  /*!
+   *  \brief register successful send with MSG_ZEROCOPY flag
+   */
+  void zero_copy_sent() noexcept {
+    _last_zero_copy_id = _next_zero_copy_id++;
+    ++_zero_copy_pending;
+  }
+
 private:
+  friend class net::stream_relay;
+
+  /**
+   * \brief part of file in send queue
+   */
+  struct queued_file {
+    size_t _preceding = 0; ///< buffered bytes which are sent before file
+    size_t _size = 0;      ///< not sent bytes of file
+    off_t _offset = 0;     ///< offset of first not sent byte
+    int _fd = -1;          ///< duplicate of file descriptor (owned by stream)
+  };
+
   /*!
    *  \brief stop all events
    */
@@ -98,21 +445,134 @@ private:
    */
   void receive_data();
 
+  /*!
+   *  \brief call on_writable of handler
+   */
+  void notify_writable();
+
+  /*!
+   *  \brief write event sends buffered data again (user callback on write event is removed)
+   */
+  void restore_send_cb();
+
   /*!
    *  \brief send data from buffer
    */
   void send_buffered_data();
 
-  bro::ev::io_t _read;                      ///< wait read event
-  bro::ev::io_t _write;                     ///< wait write event
-  strm::received_data_cb _received_data_cb; ///< receive data callback
-  std::any _param_received_data_cb;         ///< user data for receive data callback
-  strm::state_changed_cb _state_changed_cb; ///< state change callback
-  std::any _param_state_changed_cb;         ///< user data for state change callback
-  strm::send_data_cb _send_data_cb;         ///< send data callback
-  std::any _param_send_data_cb;             ///< user data for send data callback
-  buffer _send_buffer;                      ///< send buffer
-  bool _buffer_send{true};                  ///< need to buffer send data
+  /*!
+   *  \brief call send queue drained callback if buffered data fell to low watermark
+   */
+  void check_send_queue_drained();
+
+  /*!
+   *  \brief send segments of buffer with one call while socket accepts everything (cork mode)
+   */
+  void send_buffered_segments();
+
+  /*!
+   *  \brief send queued files and buffered data between them in order
+   */
+  void send_buffered_files();
+
+  /*!
+   *  \brief send bytes from the front of send buffer
+   *  \param [in,out] size number of bytes to send. decreased by sent bytes
+   *  \return false if socket is full or an error occurred
+   */
+  bool send_buffered_bytes(size_t &size);
+
+  /*!
+   *  \brief send first segment of send buffer (several segments if it is shorter than \ref get_retry_write_size)
+   *  \param [in] limit max number of bytes to send
+   *  \param [out] size number of bytes passed to protocol
+   *  \return the same as \ref send_data
+   */
+  ssize_t send_buffer_head(size_t limit, size_t &size);
+
+  /*!
+   *  \brief queue part of file after buffered data
+   *  \param [in] file_fd file descriptor of file (it is duplicated)
+   *  \param [in] offset offset of first byte in file
+   *  \param [in] size number of bytes to send
+   *  \return false if descriptor couldn't be duplicated
+   */
+  bool queue_file(int file_fd, off_t offset, size_t size);
+
+  /*!
+   *  \brief send messages from buffer one by one (for message oriented protocols)
+   */
+  void send_buffered_messages();
+
+  /*!
+   *  \brief append message to send buffer
+   *  \param [in] vec pointer on array of buffers
+   *  \param [in] count number of buffers in array
+   *  \param [in] skip number of bytes (from the begining) already sent
+   */
+  void buffer_message(iovec const *vec, size_t count, size_t skip);
+
+  /*!
+   *  \brief clear send buffer and queued files
+   */
+  void clear_send_buffer();
+
+  /*!
+   *  \brief read all available data into reactor buffer and pass it to received view callback
+   */
+  void receive_view();
+
+  /*!
+   *  \brief read zero copy notifications from error queue and call completed callback
+   */
+  void read_zero_copy_completions();
+
+  /*!
+   *  \brief append buffers to send buffer
+   *  \param [in] vec pointer on array of buffers
+   *  \param [in] count number of buffers in array
+   *  \param [in] skip number of bytes (from the begining) already sent
+   */
+  void append_to_send_buffer(iovec const *vec, size_t count, size_t skip);
+
+  net::io_ptr _read;                                            ///< wait read event
+  net::io_ptr _write;                                           ///< wait write event
+  strm::received_data_cb _received_data_cb;                     ///< receive data callback
+  std::any _param_received_data_cb;                             ///< user data for receive data callback
+  strm::state_changed_cb _state_changed_cb;                     ///< state change callback
+  std::any _param_state_changed_cb;                             ///< user data for state change callback
+  strm::send_data_cb _send_data_cb;                             ///< send data callback
+  std::any _param_send_data_cb;                                 ///< user data for send data callback
+  zero_copy_completed_cb _zero_copy_cb;                         ///< zero copy completed callback
+  std::any _param_zero_copy_cb;                                 ///< user data for zero copy completed callback
+  strm::send_data_cb _send_queue_drained_cb;                    ///< send buffer drained callback
+  std::any _param_send_queue_drained_cb;                        ///< user data for send buffer drained callback
+  received_view_cb _received_view_cb;                           ///< callback on data read by library
+  std::any _param_received_view_cb;                             ///< user data for received view callback
+  buffer _unconsumed;                                           ///< received data not consumed by received view callback
+  bool *_destroyed{nullptr};                                    ///< set if stream is destroyed by own callback
+  buffer _send_buffer;                                          ///< send buffer
+  std::deque<size_t> _buffered_messages;                        ///< sizes of buffered messages (for message oriented protocols)
+  std::deque<queued_file> _files;                               ///< queued file parts (in order with send buffer)
+  size_t _queued_file_size{0};                                  ///< not sent bytes of queued files
+  mutable std::optional<proto::ip::full_address> _self_address; ///< self address requested from socket
+  std::vector<std::byte> _message;                              ///< message crossing border of buffer segments
+  std::optional<size_t> _zero_copy_threshold;                   ///< set if zero copy is enabled
+  size_t _high_watermark{0};                                    ///< limit of buffered data (0 - not limited)
+  size_t _low_watermark{0};                                     ///< buffered data when send queue is drained
+  std::chrono::microseconds _cork_max_delay{0};                 ///< tail of corked socket is sent after it (0 - socket isn't corked)
+  std::optional<uint32_t> _last_zero_copy_id;                   ///< id of last zero copy send (if last send was zero copy)
+  uint32_t _next_zero_copy_id{0};                               ///< kernel counts zero copy sends from zero
+  size_t _zero_copy_pending{0};                                 ///< zero copy sends without completion
+  bool _buffer_send{true};                                      ///< need to buffer send data
+  bool _message_oriented{false};                                ///< need to keep message boundaries in send buffer
+  bool _sending_user_data{false};                               ///< send user memory directly (not from send buffer)
+  bool _send_queue_full{false};                                 ///< send was refused by high watermark
+  bool _cork{false};                                            ///< send only appends data to send buffer
+  bool _socket_corked{false};                                   ///< socket is corked (tail isn't sent yet)
+  bool _notify_writable{false};                                 ///< write event calls on_writable of handler
+  bool _keep_open_on_eof{false};                                ///< peer close isn't an error, stream can still send (relay)
+  bool _peer_closed{false};                                     ///< connection is closed by peer (\ref peer_closed)
 };
 
 } // namespace bro::net::send
@@ -71,14 +71,21 @@ public:
    */
   void set_state_changed_cb(strm::state_changed_cb cb, std::any param) override;
 
+  /*! \brief set handler of events (state events are handled here)
+   *  \param [in] handler pointer on handler. nullptr switches off handler
+   *  \param [in] writable_events call \ref strm::stream_handler::on_writable
+   */
+  void set_handler(strm::stream_handler *handler, bool writable_events) override;
+
 protected:
   /*! \brief create new socket with specific type
    */
   [[nodiscard]] virtual bool create_socket(proto::ip::address::version version, socket_type s_type);
 
   /*! \brief set base socket options
+   *  \param [in] non_blocking_set socket is already in non blocking mode (created/accepted with SOCK_NONBLOCK)
    */
-  [[nodiscard]] bool set_socket_options();
+  [[nodiscard]] bool set_socket_options(bool non_blocking_set = false);
 
   /*! \brief set state for stream
    * \param [in] new_state new state
@@ -106,6 +113,11 @@ protected:
    */
   virtual void cleanup();
 
+  /*! \brief get handler of events
+   *  \return handler or nullptr if it isn't set
+   */
+  strm::stream_handler *get_handler() const noexcept { return _handler; }
+
   /*! \brief return actual file descriptor
    *  \return file descriptor
    */
@@ -114,6 +126,7 @@ protected:
 private:
   friend class bro::net::listen::stream;
 
+  strm::stream_handler *_handler = nullptr; ///< handler of events (replaces callbacks)
   strm::state_changed_cb _state_changed_cb; ///< state changed callback
   std::any _param_state_changed_cb;         ///< user data for state changed callback
   std::string _err;                         ///< error description ( if set error )
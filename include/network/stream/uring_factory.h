@@ -0,0 +1,255 @@
+#pragma once
+#include <stream/factory.h>
+#include <network/common/chunk_pool.h>
+#include <network/stream/io.h>
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+
+namespace bro::net::uring {
+/** @addtogroup network_stream
+ *  @{
+ */
+
+class uring_io;
+
+/**
+ * \brief stream factory (based on io_uring)
+ *
+ * Completion based alternative of \ref ev::factory. Listen streams get connections from multishot accept
+ * and tcp streams get data from multishot recv into provided buffers ring, hence one io_uring_enter per
+ * \ref proceed replaces accept/recv system calls. Other streams (ssl, udp) are woken up by poll requests.
+ * Send is still a direct system call, because \ref strm::stream::send reports sent bytes synchronously.
+ *
+ * \note streams must be destroyed before factory
+ */
+class factory : public strm::factory {
+public:
+  /*!
+   * @brief io_uring instance parameters
+   */
+  struct config {
+    uint32_t _entries = 4096;       ///< submission queue size
+    uint16_t _buffers_count = 1024; ///< number of provided buffers for multishot recv (power of 2)
+    uint32_t _buffer_size = 4096;   ///< size of one provided buffer
+    chunk_pool::config _chunks;     ///< parameters of chunks pool (send buffers of bound streams)
+  };
+
+  /**
+   * \brief constructor with default config
+   */
+  factory();
+
+  /**
+   * \brief constructor
+   * \param [in] conf io_uring parameters
+   *
+   * \note if io_uring can't be inited factory is in failed state \ref is_active
+   */
+  explicit factory(config const &conf);
+
+  /**
+   * \brief destructor. cancels all requests and unmap rings
+   */
+  ~factory() override;
+
+  /**
+   * \brief disabled copy ctor
+   *
+   * We can't copy and handle rings
+   */
+  factory(factory const &) = delete;
+
+  /**
+   * \brief disabled move ctor
+   *
+   * Bound streams keep pointer on factory
+   */
+  factory(factory &&) = delete;
+
+  /**
+   * \brief disabled move assign operator
+   *
+   * Bound streams keep pointer on factory
+   */
+  factory &operator=(factory &&) = delete;
+
+  /**
+   * \brief disabled assign operator
+   *
+   * We can't copy and handle rings
+   */
+  factory &operator=(factory const &) = delete;
+
+  /*! \brief check io_uring can be used on this system
+   *  \return true if io_uring instance can be created (kernel support, not forbidden by sysctl/seccomp)
+   */
+  static bool is_supported() noexcept;
+
+  /*! \brief check factory is inited
+   *  \return true if io_uring is inited
+   */
+  bool is_active() const noexcept { return -1 != _ring_fd; }
+
+  /*! \brief get detailed description about error
+   *  \return error description
+   */
+  std::string const &get_error_description() const noexcept { return _err; }
+
+  /*! \brief get pool of chunks (for statistic)
+   *  \return pool of chunks
+   */
+  chunk_pool &get_chunk_pool() noexcept { return _chunks; }
+
+  /*! \brief create stream
+   *  [in] stream_set pointer on settings
+   *
+   * \note We always create stream. Even if creaion is failed.
+   * If stream created successfully we need to bind stream \ref factory::bind
+   * If something went wront we return stream with failed state and
+   * \ref stream::get_error_description can be called to get an error
+   *
+   *  \return stream_ptr created stream
+   */
+  strm::stream_ptr create_stream(strm::settings *stream_set) override;
+
+  /*! \brief bind stream
+   *  [in] stream - stream to bind
+   *
+   * \note We always need to bind created stream to factory. Only after that we start
+   * to handle all events for this stream.
+   */
+  void bind(strm::stream_ptr &stream) override;
+
+  /*! \brief proceed event loop
+   *
+   *  Submit requests, reap completions and call stream callbacks. Never waits.
+   *  Hence we need to call it periodically
+   */
+  void proceed() override;
+
+private:
+  friend class uring_io;
+
+  /*!
+   * \brief in flight request. address is user data of submission
+   */
+  struct request {
+    uring_io *_owner; ///< io which is waiting completions. nullptr if request is canceled
+    bool _accept;     ///< accept request (result is file descriptor)
+  };
+
+  /*! \brief init rings
+   *  \return true on success
+   */
+  bool init(config const &conf);
+
+  /*! \brief register provided buffers ring for multishot recv
+   *  \return true on success
+   */
+  bool init_buffers(config const &conf);
+
+  /*! \brief get free submission entry (submits queued entries if queue is full)
+   *  \return cleared entry
+   */
+  io_uring_sqe *get_sqe();
+
+  /*! \brief submit queued entries
+   *  \param [in] get_events need to flush overflowed completions
+   */
+  void submit(bool get_events = false);
+
+  /*! \brief create request for io
+   *  \param [in] owner io
+   *  \param [in] accept accept request
+   *  \return request
+   */
+  request *create_request(uring_io *owner, bool accept);
+
+  /*! \brief cancel request. request is freed on its last completion
+   *  \param [in] req request
+   *  \param [in] detach completions are ignored (owner isn't interested in them anymore)
+   */
+  void cancel(request *req, bool detach = true);
+
+  /*! \brief handle one completion
+   *  \param [in] user_data user data of request
+   *  \param [in] res result of request
+   *  \param [in] flags completion flags
+   */
+  void complete(uint64_t user_data, int32_t res, uint32_t flags);
+
+  /*! \brief get provided buffer
+   *  \param [in] id buffer id
+   *  \return pointer on buffer
+   */
+  std::byte *get_buffer(uint16_t id) noexcept { return _buffers + size_t(id) * _buffer_size; }
+
+  /*! \brief add buffer into provided buffers ring
+   *  \param [in] id buffer id
+   */
+  void provide_buffer(uint16_t id);
+
+  /*! \brief return used provided buffer into ring (and restart starving recv requests)
+   *  \param [in] id buffer id
+   */
+  void recycle_buffer(uint16_t id);
+
+  /*! \brief add io into ready list (callback will be called in this/next proceed)
+   *  \param [in] io io with events
+   */
+  void set_ready(uring_io *io);
+
+  /*! \brief submit requests which didn't fit into full submission queue
+   */
+  void retry_submissions();
+
+  /*! \brief remove io from ready and retry lists
+   *  \param [in] io io to forget
+   */
+  void forget(uring_io *io) noexcept;
+
+  int _ring_fd = -1;                       ///< io_uring file descriptor
+  void *_sq_ring = nullptr;                ///< mapped submission ring
+  size_t _sq_ring_size = 0;                ///< size of mapped submission ring
+  void *_cq_ring = nullptr;                ///< mapped completion ring
+  size_t _cq_ring_size = 0;                ///< size of mapped completion ring
+  io_uring_sqe *_sqes = nullptr;           ///< mapped submission entries
+  size_t _sqes_size = 0;                   ///< size of mapped submission entries
+  unsigned *_sq_head = nullptr;            ///< submission queue head (moved by kernel)
+  unsigned *_sq_tail = nullptr;            ///< submission queue tail
+  unsigned *_sq_flags = nullptr;           ///< submission queue flags
+  unsigned _sq_mask = 0;                   ///< submission queue mask
+  unsigned _sq_entries = 0;                ///< submission queue size
+  unsigned _sq_local_tail = 0;             ///< tail with not submitted entries
+  unsigned *_cq_head = nullptr;            ///< completion queue head
+  unsigned *_cq_tail = nullptr;            ///< completion queue tail (moved by kernel)
+  unsigned _cq_mask = 0;                   ///< completion queue mask
+  io_uring_cqe *_cqes = nullptr;           ///< completion entries
+  io_uring_buf *_buf_ring = nullptr;       ///< provided buffers ring (nullptr if isn't supported)
+  size_t _buf_ring_size = 0;               ///< size of mapped provided buffers ring
+  std::byte *_buffers = nullptr;           ///< provided buffers memory
+  size_t _buffers_size = 0;                ///< size of mapped provided buffers memory
+  uint32_t _buffer_size = 0;               ///< size of one provided buffer
+  uint16_t _buf_mask = 0;                  ///< provided buffers ring mask
+  uint16_t _buf_tail = 0;                  ///< provided buffers ring tail
+  uint64_t _recycled = 0;                  ///< number of returned provided buffers
+  std::unordered_set<request *> _requests; ///< in flight requests
+  std::vector<uring_io *> _ready;          ///< ios with events for next dispatch
+  std::vector<uring_io *> _dispatching;    ///< ios with events in current dispatch
+  std::deque<uring_io *> _starving;        ///< recv ios stopped because there were no free provided buffers
+  std::vector<uring_io *> _unarmed;        ///< ios which request didn't fit into submission queue
+  std::vector<request *> _uncanceled;      ///< requests which cancel didn't fit into submission queue
+  uring_io *_dispatched = nullptr;         ///< io which callback is called now
+  bool _destroyed = false;                 ///< dispatched io is destroyed by own callback
+  std::string _err;                        ///< error description
+  chunk_pool _chunks;                      ///< chunks for buffers of bound streams
+};
+
+} // namespace bro::net::uring
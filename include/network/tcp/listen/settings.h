@@ -1,5 +1,6 @@
 #pragma once
 #include <network/stream/listen/settings.h>
+#include <optional>
 
 namespace bro::net::tcp::listen {
 /** @addtogroup tcp_stream
@@ -8,6 +9,8 @@ namespace bro::net::tcp::listen {
 
 /*! \brief tcp receive connections settings
  */
-struct settings : net::listen::settings {};
+struct settings : net::listen::settings {
+  std::optional<uint32_t> _not_sent_low_watermark; ///< TCP_NOTSENT_LOWAT of accepted streams (see send::settings)
+};
 
 } // namespace bro::net::tcp::listen
@@ -30,7 +30,11 @@ protected:
   /*! \brief generate send tcp stream
    *  \return generated send stream
    */
-  std::unique_ptr<net::stream> generate_send_stream() override;
+  send_stream_ptr generate_send_stream() override;
+
+  /*! \brief fill/set tcp send stream with specific parameters
+   */
+  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) override;
 
   /*! \brief create new tcp listen socket and set sctp parammeters
    */
@@ -8,6 +8,8 @@ namespace bro::net::tcp::send {
 
 /*!\brief tcp send stream settings
  */
-struct settings : net::send::settings {};
+struct settings : net::send::settings {
+  std::optional<uint32_t> _not_sent_low_watermark; ///< limit of not sent data in socket buffer (TCP_NOTSENT_LOWAT)
+};
 
 } // namespace bro::net::tcp::send
@@ -1,8 +1,13 @@
 #pragma once
+#include <network/stream/send/static_stream.h>
 #include <network/stream/send/stream.h>
 #include "settings.h"
 #include "statistic.h"
 
+namespace bro::net::tcp::listen {
+class stream;
+} // namespace bro::net::tcp::listen
+
 namespace bro::net::tcp::send {
 /** @addtogroup tcp_stream
  *  @{
@@ -19,10 +24,20 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   ssize_t receive(std::byte *data, size_t data_size) override;
 
+  /*! \brief This function receive data into several buffers (using readv)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes received
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or no data yet (would block)
+   */
+  ssize_t receivev(iovec *vec, size_t count) override;
+
   /*! \brief get actual stream settings
    *  \return settings
    */
@@ -37,6 +52,16 @@ public:
    */
   void reset_statistic() override;
 
+  /*! \brief check stream can take data received by reactor (completion based factory)
+   *  \return true if zero copy isn't used (completions are read from socket error queue)
+   */
+  bool is_receive_by_reactor_supported() const noexcept override { return !_settings._zero_copy; }
+
+  /*! \brief check data of stream can be moved in kernel with splice
+   *  \return true
+   */
+  bool is_splice_supported() const noexcept override { return true; }
+
   /*!
    *  \brief init send stream
    *  \param [in] send_params pointer on parameters
@@ -51,10 +76,37 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
    */
   ssize_t send_data(std::byte const *data, size_t data_size) override;
 
+  /*! \brief send data gathered from several buffers (using sendmsg)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   */
+  ssize_t send_data_v(iovec const *vec, size_t count) override;
+
+  /*! \brief send part of file (using sendfile)
+   *  \param [in] file_fd file descriptor of file
+   *  \param [in] offset offset of first byte in file
+   *  \param [in] size number of bytes to send
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred (or file is shorter than requested)
+   *  3. Zero - zero size or socket buffer is full (would block)
+   */
+  ssize_t send_file_data(int file_fd, off_t offset, size_t size) override;
+
+  /*! \brief cork socket (TCP_CORK)
+   *  \param [in] enable cork or uncork socket
+   *  \return true if socket is corked/uncorked
+   */
+  bool cork_socket(bool enable) override;
+
   /*! \brief create new tcp send socket and set sctp parammeters
    */
   [[nodiscard]] bool create_socket(proto::ip::address::version version, socket_type s_type) override;
@@ -65,13 +117,27 @@ protected:
   [[nodiscard]] bool connection_established() override;
 
 private:
+  friend class tcp::listen::stream;
+
   /*! \brief connect stream
    *  \return true if inited. otherwise false (cause in get_error_description )
    */
   [[nodiscard]] bool connect();
 
+  /*! \brief update statistic/error for data taken from reactor
+   *  \param [in] rec result of \ref read_received
+   *  \param [in] buffer_size buffer lenght
+   *  \return rec
+   */
+  ssize_t account_received(ssize_t rec, size_t buffer_size);
+
   settings _settings;   ///< current settings
   statistic _statistic; ///< statistics
 };
 
+/**
+ * \brief tcp stream without virtual calls on data path (protocol is known at compile time)
+ */
+using static_stream = net::send::static_stream<stream>;
+
 } // namespace bro::net::tcp::send
@@ -14,6 +14,7 @@ struct settings : tcp::listen::settings {
   bool _enable_sslv2 = true;            ///< enable sslv2
   bool _enable_empty_fragments = false; ///< enable emplty fragments
   bool _enable_http2 = false;           ///< switch on/off http2 support in ssl
+  bool _enable_ktls = false;            ///< use kernel tls in accepted streams (if kernel and openssl support it)
 };
 
 } // namespace bro::net::tcp::ssl::listen
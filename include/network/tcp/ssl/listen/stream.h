@@ -23,11 +23,6 @@ public:
    */
   settings const *get_settings() const override { return &_settings; }
 
-  /*! \brief get actual stream statistic
-   *  \return stream_statistic
-   */
-  statistic const *get_statistic() const override { return &_statistic; }
-
   /*!
    *  \brief init listen stream
    *  \param [in] listen_params pointer on parameters
@@ -39,11 +34,11 @@ protected:
   /*! \brief generate send tcp ssl stream
    *  \return generated send stream
    */
-  std::unique_ptr<net::stream> generate_send_stream() override;
+  send_stream_ptr generate_send_stream() override;
 
   /*! \brief fill/set send stream with specific parameters
    */
-  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) override;
+  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) override;
 
   /*! \brief cleanup/free resources
    */
@@ -51,7 +46,6 @@ protected:
 
 private:
   settings _settings;      ///< current settings
-  statistic _statistic;    ///< statistics
   SSL_CTX *_ctx = nullptr; ///< pointer on ssl context
 };
 
@@ -23,6 +23,8 @@ struct settings : tcp::send::settings {
   bool _enable_sslv2 = true;               ///< enable sslv2
   bool _enable_empty_fragments = false;    ///< enable emplty fragments
   bool _enable_http2 = false;              ///< switch on/off http2 support in ssl
+  bool _enable_ktls = false;               ///< use kernel tls after handshake (if kernel and openssl support it)
+  bool _enable_session_cache = false;      ///< resume session of previous connection to the same peer and host name
   std::optional<ssl_version> _min_version; ///< min tls version
   std::optional<ssl_version> _max_version; ///< max tls version
 };
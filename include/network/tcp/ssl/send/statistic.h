@@ -9,5 +9,21 @@ namespace bro::net::tcp::ssl::send {
 /**
  * \brief statistic for send stream
  */
-struct statistic : public tcp::send::statistic {};
+struct statistic : public tcp::send::statistic {
+  /*! \brief add function
+   */
+  statistic &operator+=(statistic const &rhs) {
+    tcp::send::statistic::operator+=(rhs);
+    _ktls_send += rhs._ktls_send;
+    _ktls_recv += rhs._ktls_recv;
+    _full_handshakes += rhs._full_handshakes;
+    _resumed_handshakes += rhs._resumed_handshakes;
+    return *this;
+  }
+
+  uint64_t _ktls_send = 0;          ///< kernel tls is active for transmit (1 for stream, streams in sum). isn't reset
+  uint64_t _ktls_recv = 0;          ///< kernel tls is active for receive (1 for stream, streams in sum). isn't reset
+  uint64_t _full_handshakes = 0;    ///< finished full handshakes (1 for stream, streams in sum). isn't reset
+  uint64_t _resumed_handshakes = 0; ///< finished handshakes with resumed session (streams in sum). isn't reset
+};
 } // namespace bro::net::tcp::ssl::send
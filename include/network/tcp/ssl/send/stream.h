@@ -1,6 +1,9 @@
 #pragma once
 #include <network/tcp/send/stream.h>
-#include <openssl/types.h>
+#include <openssl/ssl.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "settings.h"
 #include "statistic.h"
 
@@ -26,10 +29,20 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   ssize_t receive(std::byte *data, size_t data_size) override;
 
+  /*! \brief This function receive data into several buffers (one ssl read per buffer)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes received
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or no data yet (would block)
+   */
+  ssize_t receivev(iovec *vec, size_t count) override { return strm::stream::receivev(vec, count); }
+
   /*! \brief get actual stream settings
    *  \return settings
    */
@@ -40,6 +53,20 @@ public:
    */
   statistic const *get_statistic() const override { return &_statistic; }
 
+  /*! \brief reset statistic
+   */
+  void reset_statistic() override { _statistic.reset(); }
+
+  /*! \brief check stream can take data received by reactor
+   *  \return false. ssl reads socket itself
+   */
+  bool is_receive_by_reactor_supported() const noexcept override { return false; }
+
+  /*! \brief check data of stream can be moved in kernel with splice
+   *  \return false. socket carries encrypted records
+   */
+  bool is_splice_supported() const noexcept override { return false; }
+
   /*!
    *  \brief init send stream
    *  \param [in] send_params pointer on parameters
@@ -63,17 +90,78 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
    */
   ssize_t send_data(std::byte const *data, size_t data_size) override;
 
+  /*! \brief send data gathered from several buffers. Small buffers are copied into one ssl write (one record),
+   *  big ones are written one by one. Unfinished write is retried with at least the same amount of data (part
+   *  of next buffer is gathered too)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   */
+  ssize_t send_data_v(iovec const *vec, size_t count) override;
+
+  /*! \brief get min size of next write. ssl write which got SSL_ERROR_WANT_WRITE must be retried with at least
+   *  the same amount of data
+   *  \return size of unfinished ssl write (0 - any size)
+   */
+  size_t get_retry_write_size() const noexcept override { return _pending_write; }
+
+  /*! \brief send part of file. With kernel tls file is sent with sendfile (encrypted by kernel),
+   *  otherwise it is read into user space and written with ssl
+   *  \param [in] file_fd file descriptor of file
+   *  \param [in] offset offset of first byte in file
+   *  \param [in] size number of bytes to send
+   *  \return the same as \ref send_data
+   */
+  ssize_t send_file_data(int file_fd, off_t offset, size_t size) override;
+
 private:
   friend class ssl::listen::stream;
 
-  SSL *_ctx = nullptr;            ///< pointer on ssl session
-  SSL_CTX *_client_ctx = nullptr; ///< pointer on ssl context
-  settings _settings;             ///< current settings
-  statistic _statistic;           ///< statistics
+  /*! \brief count finished handshake and check kernel tls is used. called once handshake is finished
+   */
+  void handshake_finished();
+
+  /*! \brief remember size of unfinished ssl write. ssl keeps only one record, hence it isn't bigger than record
+   *  \param [in] data_size size passed to ssl write
+   */
+  void set_pending_write(size_t data_size) noexcept {
+    _pending_write = std::min<size_t>(data_size, SSL3_RT_MAX_PLAIN_LENGTH);
+  }
+
+  /*! \brief get key of session in client session cache
+   *  \return shared ssl context, peer address and host name
+   */
+  std::string get_session_key() const;
+
+  /*! \brief new session callback (client session cache)
+   *  \param [in] ssl ssl connection
+   *  \param [in] session new session
+   *  \return 1 if session is stored (reference is taken)
+   */
+  static int new_session(SSL *ssl, SSL_SESSION *session);
+
+  /*! \brief send plain data into socket with kernel tls (kernel encrypts it)
+   *  \param [in] send_fn system call which sends data
+   *  \param [in] data_size size of data to send
+   *  \return the same as \ref send_data
+   */
+  template <typename Send> ssize_t send_ktls(Send const &send_fn, size_t data_size);
+
+  SSL *_ctx = nullptr;              ///< pointer on ssl session
+  SSL_CTX *_client_ctx = nullptr;   ///< pointer on ssl context
+  settings _settings;               ///< current settings
+  statistic _statistic;             ///< statistics
+  std::vector<std::byte> _record;   ///< small buffers gathered into one ssl write
+  size_t _pending_write = 0;        ///< size of unfinished ssl write (retry must pass at least the same size)
+  bool _handshake_finished = false; ///< handshake is finished (and kernel tls is checked)
+  bool _ktls_send = false;          ///< data is sent with kernel tls (bypassing ssl)
 };
 
 } // namespace bro::net::tcp::ssl::send
@@ -8,6 +8,13 @@ namespace bro::net::udp::send {
 
 /*!\brief tcp send stream settings
  */
-struct settings : net::send::settings {};
+struct settings : net::send::settings {
+  size_t _batch_size = 32;            ///< max datagrams per one sendmmsg/recvmmsg call
+  size_t _batch_datagram_size = 2048; ///< receive buffer size per datagram in batch mode (longer will be truncated)
+  std::optional<uint16_t> _gso_segment_size; ///< if set, enable UDP_SEGMENT. One send (up to 64KB) will be
+                                             ///< splitted by kernel on datagrams of this size (not for dtls)
+  bool _enable_gro = false; ///< enable UDP_GRO. Kernel can coalesce several datagrams in one
+                            ///< (see stream::get_segment_size). Not for dtls
+};
 
 } // namespace bro::net::udp::send
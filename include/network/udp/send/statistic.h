@@ -9,5 +9,34 @@ namespace bro::net::udp::send {
 /**
  * \brief statistic for send stream
  */
-struct statistic : public net::send::statistic {};
+struct statistic : public net::send::statistic {
+  /*! \brief reset statistics
+   */
+  void reset() override {
+    net::send::statistic::reset();
+    _batch_send_calls = 0;
+    _batch_sent_datagrams = 0;
+    _batch_recv_calls = 0;
+    _batch_received_datagrams = 0;
+    _truncated_datagrams = 0;
+  }
+
+  /*! \brief add function
+   */
+  statistic &operator+=(statistic const &rhs) {
+    net::send::statistic::operator+=(rhs);
+    _batch_send_calls += rhs._batch_send_calls;
+    _batch_sent_datagrams += rhs._batch_sent_datagrams;
+    _batch_recv_calls += rhs._batch_recv_calls;
+    _batch_received_datagrams += rhs._batch_received_datagrams;
+    _truncated_datagrams += rhs._truncated_datagrams;
+    return *this;
+  }
+
+  uint64_t _batch_send_calls = 0;         ///< successful sendmmsg calls
+  uint64_t _batch_sent_datagrams = 0;     ///< datagrams sent by sendmmsg (divide by calls to get per syscall)
+  uint64_t _batch_recv_calls = 0;         ///< successful recvmmsg calls
+  uint64_t _batch_received_datagrams = 0; ///< datagrams received by recvmmsg (divide by calls to get per syscall)
+  uint64_t _truncated_datagrams = 0;      ///< datagrams longer than batch datagram size (not passed to user)
+};
 } // namespace bro::net::udp::send
@@ -1,4 +1,7 @@
 #pragma once
+#include <sys/socket.h>
+#include <vector>
+#include <network/stream/send/static_stream.h>
 #include <network/stream/send/stream.h>
 #include "settings.h"
 #include "statistic.h"
@@ -8,6 +11,13 @@ namespace bro::net::udp::send {
  *  @{
  */
 
+/*!
+ * \brief callback on received batch of datagrams
+ *
+ * every iovec points on one received datagram. data is valid only inside callback
+ */
+using received_batch_cb = std::function<void(strm::stream *, iovec const *, size_t, std::any)>;
+
 /**
  * \brief send stream
  */
@@ -19,10 +29,52 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   ssize_t receive(std::byte *data, size_t data_size) override;
 
+  /*! \brief This function receive data into several buffers (using readv, or recvmsg with UDP_GRO)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes received
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or no data yet (would block)
+   */
+  ssize_t receivev(iovec *vec, size_t count) override;
+
+  /*! \brief This function sends several datagrams with one system call (sendmmsg)
+   *  \param [in] datagrams pointer on array of datagrams (one iovec is one datagram)
+   *  \param [in] count number of datagrams in array
+   *  \return ssize_t 2 options
+   *  1. Non negative - The number of datagrams sent
+   *  2. Negative - an error occurred
+   *
+   *  \note datagrams aren't buffered. If socket buffer is full, returns less than count
+   *  \note only for plain udp. dtls stream fails on it (datagrams would bypass dtls)
+   */
+  virtual ssize_t send_batch(iovec const *datagrams, size_t count);
+
+  /*! \brief set callback on batch of received datagrams
+   *  \param [in] cb callback function.
+   *  \param [in] param parameter for callback function
+   *  \return true if callback is set
+   *
+   *  \note replaces callback set by set_received_data_cb. On every read event
+   *  up to settings::_batch_size datagrams are received with one recvmmsg call. Datagrams longer than
+   *  settings::_batch_datagram_size aren't passed (see statistic::_truncated_datagrams). If receive failed,
+   *  stream is failed (state changed callback is called, batch callback isn't)
+   *  \note only for plain udp. dtls stream fails on it (datagrams would bypass dtls)
+   *  \note If we want to switch off, we will send nullptr as cb
+   */
+  virtual bool set_received_batch_cb(received_batch_cb cb, std::any param);
+
+  /*! \brief get segment size of last received datagram
+   *  \return size of segments kernel coalesced into last received datagram (UDP_GRO).
+   *  If datagram wasn't coalesced, it is equal to size of last received datagram
+   */
+  size_t get_segment_size() const noexcept { return _segment_size; }
+
   /*! \brief get actual stream settings
    *  \return settings
    */
@@ -50,18 +102,61 @@ protected:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full (would block)
    */
   ssize_t send_data(std::byte const *data, size_t data_size) override;
 
+  /*! \brief send data gathered from several buffers (using sendmsg)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full (would block)
+   */
+  ssize_t send_data_v(iovec const *vec, size_t count) override;
+
+  /*! \brief udp keeps message boundaries
+   *  \return true
+   */
+  bool is_message_oriented() const noexcept override { return true; }
+
   /*! \brief connect stream
    *  \return true if inited. otherwise false (cause in get_error_description )
    */
   [[nodiscard]] bool connect();
 
+  /*! \brief create new udp socket and set offload (GSO/GRO) parameters
+   */
+  [[nodiscard]] bool create_socket(proto::ip::address::version version, socket_type s_type) override;
+
 private:
-  settings _settings;   ///< current settings
-  statistic _statistic; ///< statistics
+  /*! \brief receive batch of datagrams and pass it to batch callback
+   */
+  void receive_batch();
+
+  /*! \brief receive one datagram with UDP_GRO control message
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return result of recvmsg
+   */
+  ssize_t receive_gro(iovec *vec, size_t count);
+
+  settings _settings;                    ///< current settings
+  statistic _statistic;                  ///< statistics
+  std::vector<mmsghdr> _send_msgs;       ///< reusable headers for sendmmsg
+  std::vector<mmsghdr> _recv_msgs;       ///< reusable headers for recvmmsg
+  std::vector<iovec> _recv_iovecs;       ///< reusable iovecs for recvmmsg (points on _recv_buffer)
+  std::vector<iovec> _recv_datagrams;    ///< received datagrams which we pass to batch callback
+  std::vector<std::byte> _recv_buffer;   ///< memory for received datagrams
+  received_batch_cb _received_batch_cb;  ///< batch receive callback
+  std::any _param_received_batch_cb;     ///< user data for batch receive callback
+  size_t _segment_size{0};               ///< segment size of last received datagram
 };
 
+/**
+ * \brief udp stream without virtual calls on data path (protocol is known at compile time)
+ */
+using static_stream = net::send::static_stream<stream>;
+
 } // namespace bro::net::udp::send
@@ -27,6 +27,11 @@ public:
    */
   statistic const *get_statistic() const override { return &_statistic; }
 
+  /*! \brief check stream can take connections accepted by reactor
+   *  \return false. dtls listens datagrams on socket itself
+   */
+  bool is_accept_by_reactor_supported() const noexcept override { return false; }
+
   /*!
    *  \brief init listen stream
    *  \param [in] listen_params pointer on parameters
@@ -38,11 +43,11 @@ protected:
   /*! \brief generate send sctp ssl stream
    *  \return generated send stream
    */
-  std::unique_ptr<net::stream> generate_send_stream() override;
+  send_stream_ptr generate_send_stream() override;
 
   /*! \brief fill/set send stream with specific parameters
    */
-  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) override;
+  [[nodiscard]] bool fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) override;
 
   /*! \brief cleanup/free resources
    */
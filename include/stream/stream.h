@@ -4,6 +4,7 @@
 #include <functional>
 #include <memory>
 #include <ostream>
+#include <sys/uio.h>
 
 #include "settings.h"
 #include "statistic.h"
@@ -19,6 +20,34 @@ using received_data_cb = std::function<void(stream *, std::any)>; ///< callback
 using send_data_cb = std::function<void(stream *, std::any)>;     ///< callback on send data
 using state_changed_cb = std::function<void(stream *, std::any)>; ///< callback on state change
 
+/**
+ * \brief handler of stream events
+ *
+ * Alternative of std::function callbacks with std::any parameter. Events are dispatched by one virtual call
+ * and handler keeps own typed data, hence there are no type erasure and any_cast on every event.
+ *
+ * \note handler isn't owned by stream. It must be alive while it is set to stream
+ */
+class stream_handler {
+public:
+  virtual ~stream_handler() = default;
+
+  /*! \brief data can be received
+   *  \param [in] st stream
+   */
+  virtual void on_data(stream * /*st*/) {}
+
+  /*! \brief data can be sent (called only if it is enabled in \ref stream::set_handler)
+   *  \param [in] st stream
+   */
+  virtual void on_writable(stream * /*st*/) {}
+
+  /*! \brief state of stream is changed
+   *  \param [in] st stream
+   */
+  virtual void on_state(stream * /*st*/) {}
+};
+
 /**
  * \brief stream interface
  */
@@ -44,7 +73,7 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or socket buffer is full and send bufferization is switched off
    *
    *  \note in send we use bufferization, hence we can't send half data
    */
@@ -56,10 +85,57 @@ public:
    *  \return ssize_t 3 options
    *  1. Positive - The number of bytes sent
    *  2. Negative - an error occurred
-   *  3. Zero - only if pass zero data_size
+   *  3. Zero - zero data_size or no data yet (would block)
    */
   virtual ssize_t receive(std::byte *data, size_t data_size) = 0;
 
+  /*! \brief This function sends data gathered from several buffers (scatter-gather send)
+   *  \param [in] vec pointer on array of buffers to send
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes sent
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or socket buffer is full and send bufferization is switched off
+   *
+   *  \note default implementation calls \ref send for every buffer. If some buffers are already accepted
+   *  their size is returned instead of negative value (caller must not send them again)
+   */
+  virtual ssize_t sendv(iovec const *vec, size_t count) {
+    ssize_t overall{0};
+    for (size_t i = 0; i < count; ++i) {
+      ssize_t const sent = send(static_cast<std::byte const *>(vec[i].iov_base), vec[i].iov_len);
+      if (sent < 0)
+        return overall ? overall : sent;
+      overall += sent;
+      if ((size_t) sent != vec[i].iov_len)
+        break;
+    }
+    return overall;
+  }
+
+  /*! \brief This function receive data into several buffers (scatter-gather receive)
+   *  \param [in] vec pointer on array of buffers to fill
+   *  \param [in] count number of buffers in array
+   *  \return ssize_t 3 options
+   *  1. Positive - The number of bytes received
+   *  2. Negative - an error occurred
+   *  3. Zero - zero overall size or no data yet (would block)
+   *
+   *  \note default implementation calls \ref receive for every buffer until a short read
+   */
+  virtual ssize_t receivev(iovec *vec, size_t count) {
+    ssize_t overall{0};
+    for (size_t i = 0; i < count; ++i) {
+      ssize_t const rec = receive(static_cast<std::byte *>(vec[i].iov_base), vec[i].iov_len);
+      if (rec < 0)
+        return overall ? overall : rec;
+      overall += rec;
+      if ((size_t) rec != vec[i].iov_len)
+        break;
+    }
+    return overall;
+  }
+
   /*! \brief get detailed description about error
    *  \return error description
    *
@@ -104,6 +180,27 @@ public:
    */
   virtual void set_send_data_cb(received_data_cb cb, std::any param) = 0;
 
+  /*! \brief set handler of events
+   *  \param [in] handler pointer on handler. nullptr switches off handler
+   *  \param [in] writable_events call \ref stream_handler::on_writable (like \ref set_send_data_cb)
+   *
+   *  \note handler is called instead of callbacks set by set_*_cb.
+   *  default implementation wraps handler into these callbacks
+   */
+  virtual void set_handler(stream_handler *handler, bool writable_events) {
+    if (!handler) {
+      set_received_data_cb(nullptr, {});
+      set_state_changed_cb(nullptr, {});
+      if (writable_events)
+        set_send_data_cb(nullptr, {});
+      return;
+    }
+    set_received_data_cb([handler](stream *st, std::any) { handler->on_data(st); }, {});
+    set_state_changed_cb([handler](stream *st, std::any) { handler->on_state(st); }, {});
+    if (writable_events)
+      set_send_data_cb([handler](stream *st, std::any) { handler->on_writable(st); }, {});
+  }
+
   /*! \brief get actual stream settings
    *  \return pointer on actual settings
    *
@@ -130,10 +227,63 @@ public:
   virtual void reset_statistic() = 0;
 };
 
+/*!
+ * @brief deleter of stream pointer
+ *
+ * By default deletes stream. Stream generated by pool (for instance by listen stream) is returned into
+ * this pool instead. Can be converted from std::default_delete, hence std::make_unique result can be assigned
+ */
+struct stream_deleter {
+  using recycle_t = void (*)(void *, stream *) noexcept; ///< function which returns stream into pool
+
+  /*! \brief default deleter (delete stream)
+   */
+  constexpr stream_deleter() noexcept = default;
+
+  /*! \brief deleter of pool
+   *  \param [in] recycle function which returns stream into pool
+   *  \param [in] pool pointer on pool
+   */
+  constexpr stream_deleter(recycle_t recycle, void *pool) noexcept
+    : _recycle(recycle)
+    , _pool(pool) {}
+
+  /*! \brief conversion from default deleter of derived stream
+   */
+  template <typename T>
+  constexpr stream_deleter(std::default_delete<T> const & /*del*/) noexcept {}
+
+  /*! \brief delete stream or return it into pool
+   *  \param [in] st pointer on stream
+   */
+  void operator()(stream *st) const noexcept {
+    if (_recycle)
+      _recycle(_pool, st);
+    else
+      delete st;
+  }
+
+  recycle_t _recycle = nullptr; ///< function which returns stream into pool (nullptr - delete stream)
+  void *_pool = nullptr;        ///< pool of stream
+};
+
 /*!
  * @brief stream pointer type
+ *
+ * \note it isn't std::unique_ptr<stream> (stream can be returned into pool), hence code which keeps
+ * std::unique_ptr<stream> must use stream_ptr. Released stream must be destroyed with its deleter
  */
-using stream_ptr = std::unique_ptr<stream>;
+using stream_ptr = std::unique_ptr<stream, stream_deleter>;
+
+/*!
+ * @brief get overall size of buffers in array
+ */
+[[maybe_unused]] static inline size_t get_iovec_size(iovec const *vec, size_t count) {
+  size_t size{0};
+  for (size_t i = 0; i < count; ++i)
+    size += vec[i].iov_len;
+  return size;
+}
 
 /*!
  * @brief convert state to const char * representation
@@ -0,0 +1,175 @@
+#include <network/common/buffer.h>
+#include <network/common/chunk_pool.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace bro::net {
+
+buffer::buffer(size_t chunk_size) noexcept
+  : _chunk_size(chunk_size ? chunk_size : default_chunk_size) {}
+
+buffer::~buffer() {
+  free_chunks();
+}
+
+buffer::buffer(buffer &&other) noexcept {
+  *this = std::move(other);
+}
+
+buffer &buffer::operator=(buffer &&other) noexcept {
+  if (this == &other)
+    return *this;
+  free_chunks();
+  std::memcpy(_inline.data(), other._inline.data() + other._inline_begin, other._inline_end - other._inline_begin);
+  _inline_end = other._inline_end - other._inline_begin;
+  _inline_begin = 0;
+  _head = std::exchange(other._head, nullptr);
+  _tail = std::exchange(other._tail, nullptr);
+  _spare = std::exchange(other._spare, nullptr);
+  _pool = other._pool;
+  _chunk_size = other._chunk_size;
+  _size = std::exchange(other._size, 0);
+  other._inline_begin = other._inline_end = 0;
+  return *this;
+}
+
+void buffer::set_pool(chunk_pool *pool) {
+  if (pool == _pool)
+    return;
+  buffer stored(std::move(*this));
+  free_chunks();
+  _pool = pool;
+  _chunk_size = _pool ? _pool->get_chunk_size() - sizeof(chunk) : default_chunk_size;
+  for (auto data = stored.get_data(); data.second; data = stored.get_data()) {
+    append(data.first, data.second);
+    stored.erase(data.second);
+  }
+}
+
+buffer::chunk *buffer::acquire_chunk() {
+  chunk *ch = std::exchange(_spare, nullptr);
+  if (!ch)
+    ch = new (_pool ? _pool->acquire() : ::operator new(sizeof(chunk) + _chunk_size)) chunk;
+  ch->_next = nullptr;
+  ch->_begin = ch->_end = 0;
+  return ch;
+}
+
+void buffer::release_chunk(chunk *ch) noexcept {
+  // pool is a cache of chunks itself
+  if (_pool) {
+    ch->~chunk();
+    _pool->release(ch);
+    return;
+  }
+  if (!_spare) {
+    _spare = ch;
+    return;
+  }
+  ch->~chunk();
+  ::operator delete(ch);
+}
+
+void buffer::free_chunks() noexcept {
+  clear();
+  if (_spare) {
+    _spare->~chunk();
+    ::operator delete(_spare);
+    _spare = nullptr;
+  }
+}
+
+void buffer::append(std::byte const *data, size_t data_size) {
+  if (!data_size)
+    return;
+  _size += data_size;
+
+  // tiny backlog - use inline storage while there are no chunks (keep data order)
+  if (!_head && _inline_end + data_size <= inline_size) {
+    std::memcpy(_inline.data() + _inline_end, data, data_size);
+    _inline_end += data_size;
+    return;
+  }
+
+  while (data_size) {
+    if (!_tail || _tail->_end == _chunk_size) {
+      chunk *ch = acquire_chunk();
+      if (_tail)
+        _tail->_next = ch;
+      else
+        _head = ch;
+      _tail = ch;
+    }
+    size_t const to_copy = std::min(data_size, _chunk_size - _tail->_end);
+    std::memcpy(_tail->data() + _tail->_end, data, to_copy);
+    _tail->_end += to_copy;
+    data += to_copy;
+    data_size -= to_copy;
+  }
+}
+
+size_t buffer::copy(std::byte *dest, size_t n) const noexcept {
+  n = std::min(n, _size);
+  size_t copied = std::min(n, _inline_end - _inline_begin);
+  std::memcpy(dest, _inline.data() + _inline_begin, copied);
+  for (chunk const *ch = _head; ch && copied != n; ch = ch->_next) {
+    size_t const to_copy = std::min(n - copied, ch->_end - ch->_begin);
+    std::memcpy(dest + copied, ch->data() + ch->_begin, to_copy);
+    copied += to_copy;
+  }
+  return copied;
+}
+
+size_t buffer::get_segments(iovec *vec, size_t count) const noexcept {
+  size_t filled = 0;
+  if (count && _inline_end != _inline_begin)
+    vec[filled++] = {const_cast<std::byte *>(_inline.data()) + _inline_begin, _inline_end - _inline_begin};
+  for (chunk const *ch = _head; ch && filled != count; ch = ch->_next)
+    vec[filled++] = {const_cast<std::byte *>(ch->data()) + ch->_begin, ch->_end - ch->_begin};
+  return filled;
+}
+
+void buffer::erase(size_t n) {
+  if (n >= _size) {
+    clear();
+    return;
+  }
+  _size -= n;
+
+  if (size_t const in_inline = _inline_end - _inline_begin; in_inline) {
+    if (n < in_inline) {
+      _inline_begin += n;
+      return;
+    }
+    n -= in_inline;
+    _inline_begin = _inline_end = 0;
+  }
+
+  while (n) {
+    size_t const in_chunk = _head->_end - _head->_begin;
+    if (n < in_chunk) {
+      _head->_begin += n;
+      return;
+    }
+    n -= in_chunk;
+    chunk *drained = _head;
+    _head = _head->_next;
+    release_chunk(drained);
+  }
+  if (!_head)
+    _tail = nullptr;
+}
+
+void buffer::clear() {
+  _inline_begin = _inline_end = 0;
+  while (_head) {
+    chunk *drained = _head;
+    _head = _head->_next;
+    release_chunk(drained);
+  }
+  _tail = nullptr;
+  _size = 0;
+}
+
+} // namespace bro::net
@@ -0,0 +1,80 @@
+#include <network/common/chunk_pool.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <new>
+
+namespace bro::net {
+
+/*! \brief chunks are aligned on cache line
+ */
+static constexpr size_t chunk_alignment = 64;
+
+/*! \brief size of explicit huge page
+ */
+static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+chunk_pool::chunk_pool() noexcept
+  : chunk_pool(config{}) {}
+
+chunk_pool::chunk_pool(config const &conf) noexcept
+  : _chunk_size((std::max(conf._chunk_size, sizeof(free_chunk)) + chunk_alignment - 1) & ~(chunk_alignment - 1))
+  , _chunks_per_slab(std::max<size_t>(conf._chunks_per_slab, 1))
+  , _huge_pages(conf._huge_pages) {}
+
+chunk_pool::~chunk_pool() {
+  for (auto const &sl : _slabs)
+    ::munmap(sl._memory, sl._size);
+}
+
+void chunk_pool::allocate_slab() {
+  size_t size = _chunk_size * _chunks_per_slab;
+  void *memory = MAP_FAILED;
+  if (_huge_pages) {
+    size_t const huge_size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+    memory = ::mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (MAP_FAILED != memory) {
+      size = huge_size;
+      ++_statistic._huge_page_slabs;
+    }
+  }
+  if (MAP_FAILED == memory) {
+    memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == memory)
+      throw std::bad_alloc();
+    // explicit huge pages aren't reserved in system. ask for transparent ones
+    if (_huge_pages)
+      ::madvise(memory, size, MADV_HUGEPAGE);
+  }
+  _slabs.push_back({memory, size});
+  _statistic._resident_bytes += size;
+
+  // put chunks in address order, hence neighbour chunks are taken one by one
+  auto *begin = static_cast<std::byte *>(memory);
+  for (size_t i = size / _chunk_size; i > 0; --i) {
+    auto *ch = reinterpret_cast<free_chunk *>(begin + (i - 1) * _chunk_size);
+    ch->_next = _free;
+    _free = ch;
+  }
+}
+
+void *chunk_pool::acquire() {
+  if (_free) {
+    ++_statistic._hits;
+  } else {
+    ++_statistic._misses;
+    allocate_slab();
+  }
+  free_chunk *ch = _free;
+  _free = ch->_next;
+  ++_statistic._used_chunks;
+  return ch;
+}
+
+void chunk_pool::release(void *chunk) noexcept {
+  auto *ch = static_cast<free_chunk *>(chunk);
+  ch->_next = _free;
+  _free = ch;
+  --_statistic._used_chunks;
+}
+
+} // namespace bro::net
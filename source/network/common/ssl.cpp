@@ -1,6 +1,11 @@
 #include "openssl/rand.h"
 #include <array>
 #include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <network/common/ssl.h>
 #include <network/platforms/system.h>
 #include <openssl/err.h>
@@ -42,6 +47,181 @@ bool set_cipher_list(SSL_CTX *ctx, std::string const &ciphers, std::string &err)
   return true;
 }
 
+/*! \brief order of client context parameters (key of shared contexts)
+ */
+struct client_ctx_params_less {
+  bool operator()(client_ctx_params const &lhs, client_ctx_params const &rhs) const {
+    return std::tie(lhs._method,
+                    lhs._min_version,
+                    lhs._max_version,
+                    lhs._options,
+                    lhs._mode,
+                    lhs._verify_depth,
+                    lhs._certificate_path,
+                    lhs._key_path,
+                    lhs._new_session_cb)
+           < std::tie(rhs._method,
+                      rhs._min_version,
+                      rhs._max_version,
+                      rhs._options,
+                      rhs._mode,
+                      rhs._verify_depth,
+                      rhs._certificate_path,
+                      rhs._key_path,
+                      rhs._new_session_cb);
+  }
+};
+
+/*! \brief shared client context
+ */
+struct shared_client_ctx {
+  SSL_CTX *_ctx = nullptr; ///< context
+  size_t _refs = 0;        ///< number of streams which use context
+};
+
+static std::mutex client_ctx_guard;
+static std::map<client_ctx_params, shared_client_ctx, client_ctx_params_less> client_ctxs;
+
+/*! \brief create and set up client context
+ *  \param [in] params parameters of context
+ *  \param [out] err will be filled with error if something go wrong
+ *  \return pointer on context or nullptr on error
+ */
+static SSL_CTX *create_client_ctx(client_ctx_params const &params, std::string &err) {
+  SSL_CTX *ctx = SSL_CTX_new(params._method);
+  if (!ctx) {
+    err = fill_error("couldn't create ssl client context");
+    return nullptr;
+  }
+
+  if (params._min_version)
+    SSL_CTX_set_min_proto_version(ctx, params._min_version);
+  if (params._max_version)
+    SSL_CTX_set_max_proto_version(ctx, params._max_version);
+  SSL_CTX_set_mode(ctx, params._mode);
+  //NOTE: probably we can check return mask, but I don't see why we need it and how to handle it
+  SSL_CTX_set_options(ctx, params._options);
+
+  if (!params._certificate_path.empty() && !params._key_path.empty()) {
+    if (!set_check_ceritficate(ctx, params._certificate_path, params._key_path, err)) {
+      SSL_CTX_free(ctx);
+      return nullptr;
+    }
+    if (params._verify_depth >= 0)
+      SSL_CTX_set_verify_depth(ctx, params._verify_depth);
+  }
+
+  if (params._new_session_cb) {
+    // sessions are kept by user (per peer), not in internal cache of context
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, params._new_session_cb);
+  }
+  return ctx;
+}
+
+SSL_CTX *acquire_client_ctx(client_ctx_params const &params, std::string &err) {
+  // context isn't changed after creation, hence it can be used by streams from different threads
+  std::lock_guard<std::mutex> lock(client_ctx_guard);
+  auto it = client_ctxs.find(params);
+  if (it == client_ctxs.end()) {
+    SSL_CTX *ctx = create_client_ctx(params, err);
+    if (!ctx)
+      return nullptr;
+    it = client_ctxs.emplace(params, shared_client_ctx{ctx, 0}).first;
+  }
+  ++it->second._refs;
+  return it->second._ctx;
+}
+
+void release_client_ctx(SSL_CTX *ctx) {
+  std::lock_guard<std::mutex> lock(client_ctx_guard);
+  for (auto it = client_ctxs.begin(); it != client_ctxs.end(); ++it) {
+    if (it->second._ctx != ctx)
+      continue;
+    if (!--it->second._refs) {
+      SSL_CTX_free(ctx);
+      client_ctxs.erase(it);
+    }
+    return;
+  }
+}
+
+/*! \brief max number of sessions in client session cache
+ */
+static constexpr size_t client_sessions_max = 16 * 1024;
+
+/*!
+ * \brief cached client session
+ */
+struct client_session {
+  SSL_SESSION *_session = nullptr;           ///< session
+  SSL_CTX *_ctx = nullptr;                   ///< context session is created with (cache keeps reference on it)
+  std::list<std::string>::iterator _lru_pos; ///< position in recently used list
+};
+
+static std::mutex client_session_guard;
+static std::unordered_map<std::string, client_session> client_sessions;
+static std::list<std::string> client_sessions_lru; ///< keys of sessions. recently used is the first
+
+/*! \brief free cached session and release its context
+ *  \param [in] cached cached session
+ */
+static void free_client_session(client_session const &cached) {
+  SSL_SESSION_free(cached._session);
+  release_client_ctx(cached._ctx);
+}
+
+/*! \brief remove session from cache and free it
+ *  \param [in] it cached session
+ */
+static void erase_client_session(std::unordered_map<std::string, client_session>::iterator it) {
+  free_client_session(it->second);
+  client_sessions_lru.erase(it->second._lru_pos);
+  client_sessions.erase(it);
+}
+
+std::string get_client_session_prefix(SSL_CTX *ctx) {
+  return std::to_string(reinterpret_cast<uintptr_t>(ctx)) + "/";
+}
+
+void store_client_session(SSL_CTX *ctx, std::string const &key, SSL_SESSION *session) {
+  std::lock_guard<std::mutex> lock(client_session_guard);
+  auto it = client_sessions.find(key);
+  if (it != client_sessions.end()) {
+    // key contains context, hence it is the same
+    SSL_SESSION_free(it->second._session);
+    it->second._session = session;
+    client_sessions_lru.splice(client_sessions_lru.begin(), client_sessions_lru, it->second._lru_pos);
+    return;
+  }
+  // unbounded cache would grow with every peer. least recently used session is dropped (it costs one full handshake)
+  if (client_sessions.size() >= client_sessions_max)
+    erase_client_session(client_sessions.find(client_sessions_lru.back()));
+  {
+    std::lock_guard<std::mutex> ctx_lock(client_ctx_guard);
+    for (auto &shared : client_ctxs) {
+      if (shared.second._ctx == ctx)
+        ++shared.second._refs;
+    }
+  }
+  client_sessions_lru.push_front(key);
+  client_sessions.emplace(key, client_session{session, ctx, client_sessions_lru.begin()});
+}
+
+SSL_SESSION *get_client_session(std::string const &key) {
+  std::lock_guard<std::mutex> lock(client_session_guard);
+  auto it = client_sessions.find(key);
+  if (it == client_sessions.end())
+    return nullptr;
+  if (!SSL_SESSION_is_resumable(it->second._session)) {
+    erase_client_session(it);
+    return nullptr;
+  }
+  client_sessions_lru.splice(client_sessions_lru.begin(), client_sessions_lru, it->second._lru_pos);
+  SSL_SESSION_up_ref(it->second._session);
+  return it->second._session;
+}
+
 enum init_state : int {
   e_not_init = 0,
   e_in_progress,
@@ -1,5 +1,6 @@
 #include <network/platforms/system.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <ifaddrs.h>
 #include <sys/ioctl.h>
@@ -70,6 +71,86 @@ bool set_tcp_options(int file_descr, std::string &err) {
   return true;
 }
 
+bool set_not_sent_low_watermark(int file_descr, uint32_t bytes, std::string &err) {
+#ifdef TCP_NOTSENT_LOWAT
+  int optval = (int) bytes;
+  if (0 != ::setsockopt(file_descr, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &optval, sizeof(optval))) {
+    append_error(err, "couldn't set not sent low watermark (TCP_NOTSENT_LOWAT)");
+    errno = 0;
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  (void) bytes;
+  append_error(err, "not sent low watermark (TCP_NOTSENT_LOWAT) isn't supported");
+  return false;
+#endif // TCP_NOTSENT_LOWAT
+}
+
+bool set_tcp_cork(int file_descr, bool enable, std::string &err) {
+#ifdef TCP_CORK
+  int optval = enable ? 1 : 0;
+  if (0 != ::setsockopt(file_descr, IPPROTO_TCP, TCP_CORK, &optval, sizeof(optval))) {
+    append_error(err, "couldn't set tcp cork (TCP_CORK)");
+    errno = 0;
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  (void) enable;
+  append_error(err, "tcp cork (TCP_CORK) isn't supported");
+  return false;
+#endif // TCP_CORK
+}
+
+bool enable_zero_copy(int file_descr, std::string &err) {
+#ifdef SO_ZEROCOPY
+  int optval = 1;
+  if (0 != ::setsockopt(file_descr, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof(optval))) {
+    append_error(err, "couldn't enable zero copy (SO_ZEROCOPY)");
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  append_error(err, "zero copy (SO_ZEROCOPY) isn't supported");
+  return false;
+#endif // SO_ZEROCOPY
+}
+
+bool set_udp_segment_size(int file_descr, uint16_t segment_size, std::string &err) {
+#ifdef UDP_SEGMENT
+  int optval = segment_size;
+  if (0 != ::setsockopt(file_descr, SOL_UDP, UDP_SEGMENT, &optval, sizeof(optval))) {
+    append_error(err, "couldn't set udp segment size (UDP_SEGMENT)");
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  (void) segment_size;
+  append_error(err, "udp segmentation offload (UDP_SEGMENT) isn't supported");
+  return false;
+#endif // UDP_SEGMENT
+}
+
+bool enable_udp_gro(int file_descr, std::string &err) {
+#ifdef UDP_GRO
+  int optval = 1;
+  if (0 != ::setsockopt(file_descr, SOL_UDP, UDP_GRO, &optval, sizeof(optval))) {
+    append_error(err, "couldn't enable udp receive offload (UDP_GRO)");
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  append_error(err, "udp receive offload (UDP_GRO) isn't supported");
+  return false;
+#endif // UDP_GRO
+}
+
 bool is_connection_established(int file_descr, std::string &err) {
   int optval = -1;
   socklen_t optlen = sizeof(optval);
@@ -381,6 +462,21 @@ bool reuse_address(int file_descr, std::string &err) {
   return true;
 }
 
+bool reuse_port(int file_descr, std::string &err) {
+#ifdef SO_REUSEPORT
+  int reuseport = 1;
+  if (-1 == setsockopt(file_descr, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<void const *>(&reuseport), sizeof(int))) {
+    append_error(err, "couldn't reuse port");
+    return false;
+  }
+  return true;
+#else
+  (void) file_descr;
+  append_error(err, "reuse port isn't supported on this platform");
+  return false;
+#endif // SO_REUSEPORT
+}
+
 bool start_listen(int file_descr, int listen_backlog, std::string &err) {
   if (0 != ::listen(file_descr, listen_backlog)) {
     append_error(err, "server listen is failed");
@@ -468,52 +564,74 @@ bool close_socket(int &file_descr, std::string &err) {
   return res;
 }
 
-accept_connection_res accept_connection(proto::ip::address::version ver, int server_fd, std::string &err) {
-  accept_connection_details res;
-  res._client_fd = -1;
+accept_connection_res accept_connection(proto::ip::address::version ver,
+                                        int server_fd,
+                                        bool non_blocking,
+                                        std::string &err) {
+  union {
+    sockaddr_in v4;
+    sockaddr_in6 v6;
+  } t_peer_addr{};
+  socklen_t addrlen{0};
   switch (ver) {
-  case proto::ip::address::version::e_v4: {
-    struct sockaddr_in t_peer_addr = {0, 0, {0}, {0}};
-    socklen_t addrlen = sizeof(t_peer_addr);
-    while (true) {
-      res._client_fd = accept(server_fd, (struct sockaddr *) (&t_peer_addr), &addrlen);
-      if (-1 == res._client_fd) {
-        if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno)
-          break;
-      } else
-        break;
-    }
-
-    if (-1 != res._client_fd)
-      res._peer_addr = proto::ip::full_address(t_peer_addr);
+  case proto::ip::address::version::e_v4:
+    addrlen = sizeof(t_peer_addr.v4);
     break;
-  }
-  case proto::ip::address::version::e_v6: {
-    sockaddr_in6 t_peer_addr = {0, 0, 0, {{{0}}}, 0};
-    socklen_t addrlen = sizeof(t_peer_addr);
-    while (true) {
-      res._client_fd = accept(server_fd, (struct sockaddr *) (&t_peer_addr), &addrlen);
-      if (-1 == res._client_fd) {
-        if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno)
-          break;
-      } else
-        break;
-    }
-    if (-1 != res._client_fd)
-      res._peer_addr = proto::ip::full_address(t_peer_addr);
+  case proto::ip::address::version::e_v6:
+    addrlen = sizeof(t_peer_addr.v6);
     break;
-  }
   default:
     append_error(err, "incorrect address version");
-    break;
+    return std::nullopt;
   }
-  if (-1 != res._client_fd) {
-    if (auto addr = get_address_from_file_descr(ver, res._client_fd); addr) // NOTE: actualy it never fails
-      res._self_address = *addr;
-    return res;
-  } else
+
+  int const flags = SOCK_CLOEXEC | (non_blocking ? SOCK_NONBLOCK : 0);
+  int client_fd{-1};
+  while (true) {
+    client_fd = ::accept4(server_fd, (struct sockaddr *) (&t_peer_addr), &addrlen, flags);
+    if (-1 != client_fd)
+      break;
+    if (EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+    if (EAGAIN == errno || EWOULDBLOCK == errno) {
+      // no pending connections
+      errno = 0;
+      return std::nullopt;
+    }
     append_error(err, "coulnd't accept connection");
-  return std::nullopt;
+    return std::nullopt;
+  }
+
+  accept_connection_details res;
+  res._client_fd = client_fd;
+  if (proto::ip::address::version::e_v4 == ver)
+    res._peer_addr = proto::ip::full_address(t_peer_addr.v4);
+  else
+    res._peer_addr = proto::ip::full_address(t_peer_addr.v6);
+  return res;
+}
+
+accept_connection_res accepted_connection(proto::ip::address::version ver, int client_fd, std::string &err) {
+  union {
+    sockaddr_in v4;
+    sockaddr_in6 v6;
+  } t_peer_addr{};
+  socklen_t addrlen = proto::ip::address::version::e_v4 == ver ? sizeof(t_peer_addr.v4) : sizeof(t_peer_addr.v6);
+  if (proto::ip::address::version::e_none == ver || 0 != ::getpeername(client_fd, (sockaddr *) &t_peer_addr, &addrlen)) {
+    append_error(err, "couldn't get peer address of accepted connection");
+    ::close(client_fd);
+    return std::nullopt;
+  }
+
+  accept_connection_details res;
+  res._client_fd = client_fd;
+  if (proto::ip::address::version::e_v4 == ver)
+    res._peer_addr = proto::ip::full_address(t_peer_addr.v4);
+  else
+    res._peer_addr = proto::ip::full_address(t_peer_addr.v6);
+  return res;
 }
 
 } // namespace bro::net
@@ -7,6 +7,7 @@ namespace bro::net::sctp::listen {
 bool stream::create_listen_socket() {
   if (create_socket(_settings._listen_address.get_address().get_version(), socket_type::e_sctp)
       && reuse_address(get_fd(), get_error_description())
+      && (!_settings._reuse_port || reuse_port(get_fd(), get_error_description()))
       && bind_on_sctp_address(_settings._listen_address, get_fd(), get_error_description())
       && start_listen(get_fd(), _settings._listen_backlog, get_error_description()))
     return true;
@@ -14,7 +15,7 @@ bool stream::create_listen_socket() {
   return false;
 }
 
-bool stream::fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) {
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) {
   if (!net::listen::stream::fill_send_stream(result, sck))
     return false;
 
@@ -23,8 +24,8 @@ bool stream::fill_send_stream(accept_connection_res const &result, std::unique_p
   return true;
 }
 
-std::unique_ptr<net::stream> stream::generate_send_stream() {
-  return std::make_unique<bro::net::sctp::send::stream>();
+stream::send_stream_ptr stream::generate_send_stream() {
+  return make_send_stream<bro::net::sctp::send::stream>();
 }
 
 bool stream::init(settings *listen_params) {
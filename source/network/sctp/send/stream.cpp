@@ -24,12 +24,20 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == sent && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_send_data;
       continue;
     }
 
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (data_size == 0 && sent == 0)
       break;
@@ -41,6 +49,50 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
   return sent;
 }
 
+ssize_t stream::send_data_v(iovec const *vec, size_t count) {
+  ssize_t sent{0};
+  sctp_sndinfo sinfo{0, uint16_t(_settings._unordered ? SCTP_UNORDERED : 0), htonl(_settings._ppid), 0, 0};
+  while (true) {
+    sent = sctp_sendv(get_fd(),
+                      vec,
+                      (int) count,
+                      nullptr,
+                      0,
+                      &sinfo,
+                      sizeof(sinfo),
+                      SCTP_SENDV_SNDINFO,
+                      MSG_NOSIGNAL);
+
+    if (sent > 0) {
+      ++_statistic._success_send_data;
+      break;
+    }
+
+    if (-1 == sent && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
+    // 0 may also be returned if the requested number of bytes to send was 0
+    if (sent == 0 && strm::get_iovec_size(vec, count) == 0)
+      break;
+
+    set_detailed_error("sctp_sendv return error");
+    sent = -1;
+    break;
+  }
+  return sent;
+}
+
 ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
   sctp_sndrcvinfo sinfo{0, 0, uint16_t(_settings._unordered ? SCTP_UNORDERED : 0), htonl(_settings._ppid), 0, 0, 0, 0, 0};
   ssize_t rec{-1};
@@ -57,12 +109,20 @@ ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == rec && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_recv_data;
       continue;
     }
 
+    if (-1 == rec && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // no data yet. would block
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      rec = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (buffer_size == 0 && rec == 0)
       break;
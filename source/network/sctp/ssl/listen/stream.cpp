@@ -17,11 +17,11 @@ stream::~stream() {
   stream::cleanup();
 }
 
-std::unique_ptr<net::stream> stream::generate_send_stream() {
-  return std::make_unique<bro::net::sctp::ssl::send::stream>();
+stream::send_stream_ptr stream::generate_send_stream() {
+  return make_send_stream<bro::net::sctp::ssl::send::stream>();
 }
 
-bool stream::fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) {
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) {
   if (!sctp::listen::stream::fill_send_stream(result, sck))
     return false;
 
@@ -68,6 +68,9 @@ bool stream::init(settings *listen_params) {
     return false;
   }
 
+  /* After SSL_ERROR_WANT_WRITE write is retried from the send buffer (other address) */
+  SSL_CTX_set_mode(_server_ctx, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
   ctx_option_t ctx_options = (SSL_OP_ALL & ~SSL_OP_DONT_INSERT_EMPTY_FRAGMENTS);
 
 #ifdef SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG
@@ -0,0 +1,221 @@
+#include <network/platforms/system.h>
+#include <network/stream/epoll_factory.h>
+#include <network/stream/factory.h>
+#include <network/stream/listen/stream.h>
+#include <network/stream/registry.h>
+#include <network/stream/send/stream.h>
+#include <algorithm>
+#include <unistd.h>
+
+namespace bro::net::epoll {
+
+/*! \brief events of file descriptor added into epoll. interest is kept in user space, hence it never changes
+ */
+static constexpr uint32_t registration_events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
+/**
+ * \brief readiness based io on edge triggered epoll
+ *
+ * Read and write io of stream share one registration of file descriptor.
+ * Callback is called from \ref factory::proceed while registration is ready for this io.
+ */
+class epoll_io : public net::io {
+public:
+  /*! \brief constructor
+   *  \param [in] manager owning factory
+   *  \param [in] read read io (otherwise write)
+   */
+  epoll_io(factory &manager, bool read) noexcept
+    : _factory(manager)
+    , _read(read) {}
+
+  ~epoll_io() override { stop(); }
+
+  epoll_io(epoll_io const &) = delete;
+  epoll_io &operator=(epoll_io const &) = delete;
+
+  void start(int fd, callback_t cb) override {
+    _cb = std::move(cb);
+    start(fd);
+  }
+
+  void start(int fd) override {
+    if (_reg && fd == _reg->_fd)
+      return;
+    stop();
+    _reg = _factory.attach(fd, this, _read);
+  }
+
+  void stop() override {
+    if (!_reg)
+      return;
+    _factory.detach(_reg, _read);
+    _reg = nullptr;
+  }
+
+  void set_callback(callback_t cb) override { _cb = std::move(cb); }
+
+  bool is_active() const override { return _reg; }
+
+  void would_block() noexcept override {
+    if (_reg)
+      (_read ? _reg->_readable : _reg->_writable) = false;
+  }
+
+  /*! \brief call callback. streams pass lambda with pointer on stream, it is kept in small buffer of
+   *  std::function, hence call is one indirect call to member function of stream (like virtual call)
+   */
+  void call() { _cb(); }
+
+private:
+  factory &_factory;                     ///< owning factory
+  factory::registration *_reg = nullptr; ///< registration of file descriptor (nullptr if io isn't started)
+  callback_t _cb;                        ///< callback on event
+  bool _read;                            ///< read io (otherwise write)
+};
+
+factory::factory()
+  : factory(config{}) {}
+
+factory::factory(config const &conf)
+  : _chunks(conf._chunks) {
+  _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  if (-1 == _epoll_fd) {
+    append_error(_err, "couldn't create epoll");
+    return;
+  }
+  _events.resize(conf._max_events ? conf._max_events : 1);
+}
+
+factory::~factory() {
+  for (auto *reg : _registrations)
+    delete reg;
+  for (auto *reg : _released)
+    delete reg;
+  for (auto *reg : _free)
+    delete reg;
+  if (-1 != _epoll_fd)
+    ::close(_epoll_fd);
+}
+
+strm::stream_ptr factory::create_stream(strm::settings *stream_set) {
+  return net::create_stream(stream_set);
+}
+
+void factory::bind(strm::stream_ptr &stream) {
+  switch (get_stream_kind(stream.get())) {
+  case stream_kind::e_send: {
+    auto *st = static_cast<bro::net::send::stream *>(stream.get());
+    st->set_chunk_pool(&_chunks);
+    st->assign_events(std::make_unique<epoll_io>(*this, true), std::make_unique<epoll_io>(*this, false));
+    break;
+  }
+  case stream_kind::e_listen:
+    static_cast<bro::net::listen::stream *>(stream.get())->assign_event(std::make_unique<epoll_io>(*this, true));
+    break;
+  default:
+    break;
+  }
+}
+
+factory::registration *factory::attach(int fd, epoll_io *io, bool read) {
+  if (fd < 0)
+    return nullptr;
+  if ((size_t) fd >= _registrations.size())
+    _registrations.resize(fd + 1, nullptr);
+
+  registration *reg = _registrations[fd];
+  if (!reg) {
+    if (_free.empty()) {
+      reg = new registration;
+    } else {
+      reg = _free.back();
+      _free.pop_back();
+      *reg = registration{};
+    }
+    reg->_fd = fd;
+    epoll_event ev{};
+    ev.events = registration_events;
+    ev.data.ptr = reg;
+    if (-1 == ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev)) {
+      append_error(_err, "couldn't add file descriptor into epoll");
+      _free.push_back(reg);
+      return nullptr;
+    }
+    _registrations[fd] = reg;
+  }
+
+  (read ? reg->_read : reg->_write) = io;
+  // edge was got before io is started (for instance socket is still writable)
+  if (read ? reg->_readable : reg->_writable)
+    set_ready(reg);
+  return reg;
+}
+
+void factory::detach(registration *reg, bool read) {
+  (read ? reg->_read : reg->_write) = nullptr;
+  if (reg->_read || reg->_write)
+    return;
+  ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, reg->_fd, nullptr);
+  _registrations[reg->_fd] = nullptr;
+  reg->_fd = -1;
+  // ready lists can point on registration, hence it is reused only at the end of proceed
+  _released.push_back(reg);
+}
+
+void factory::set_ready(registration *reg) {
+  if (reg->_in_ready)
+    return;
+  reg->_in_ready = true;
+  _ready.push_back(reg);
+}
+
+void factory::dispatch(registration *reg) {
+  // io can be stopped (or stream destroyed) by any callback
+  if (reg->_read && reg->_readable)
+    reg->_read->call();
+  if (reg->_write && reg->_writable)
+    reg->_write->call();
+  // stream didn't read/write everything. call it again in next proceed
+  if ((reg->_read && reg->_readable) || (reg->_write && reg->_writable))
+    set_ready(reg);
+}
+
+void factory::proceed() {
+  if (!is_active())
+    return;
+
+  int count{0};
+  do {
+    count = ::epoll_wait(_epoll_fd, _events.data(), (int) _events.size(), 0);
+  } while (-1 == count && EINTR == errno);
+
+  for (int i = 0; i < count; ++i) {
+    auto *reg = static_cast<registration *>(_events[i].data.ptr);
+    uint32_t const events = _events[i].events;
+    // errors and hangup are reported by both read and write system calls
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+      reg->_readable = true;
+    if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+      reg->_writable = true;
+    set_ready(reg);
+  }
+
+  _dispatching.swap(_ready);
+  for (auto *reg : _dispatching) {
+    reg->_in_ready = false;
+    dispatch(reg);
+  }
+  _dispatching.clear();
+
+  if (!_released.empty()) {
+    for (auto *reg : _released) {
+      if (reg->_in_ready)
+        _ready.erase(std::find(_ready.begin(), _ready.end(), reg));
+      _free.push_back(reg);
+    }
+    _released.clear();
+  }
+}
+
+} // namespace bro::net::epoll
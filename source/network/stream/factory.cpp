@@ -1,104 +1,207 @@
-#ifdef WITH_TCP_SSL
-#include <network/tcp/ssl/listen/stream.h>
-#include <network/tcp/ssl/send/stream.h>
-#endif // WITH_TCP_SSL
-#ifdef WITH_SCTP
-#include <network/sctp/listen/stream.h>
-#include <network/sctp/send/stream.h>
-#endif // WITH_SCTP
-#ifdef WITH_SCTP_SSL
-#include <network/sctp/ssl/listen/stream.h>
-#include <network/sctp/ssl/send/stream.h>
-#endif // WITH_SCTP_SSL
-#ifdef WITH_UDP_SSL
-#include <network/udp/ssl/listen/stream.h>
-#include <network/udp/ssl/send/stream.h>
-#endif // WITH_UDP_SSL
 #include <network/stream/factory.h>
-#include <network/tcp/listen/stream.h>
-#include <network/tcp/send/stream.h>
-#include <network/udp/send/stream.h>
+#include <network/stream/listen/stream.h>
+#include <network/stream/registry.h>
+#include <network/stream/relay.h>
+#include <network/stream/send/stream.h>
+#include <algorithm>
 
 namespace bro::net::ev {
 
+/**
+ * \brief readiness based io (libev watcher)
+ *
+ * Watcher is stopped lazily - on its first event after \ref stop (event isn't passed to stream).
+ * If stream starts io again before that, libev and epoll interest set aren't touched at all.
+ * The price is one spurious wakeup: stopped watcher fires once more and only then is stopped in libev.
+ * Deferred io is kept in lists of factory and is called at the end of \ref factory::proceed.
+ */
+class ev_io : public net::io {
+public:
+  /*! \brief constructor
+   *  \param [in] manager owning factory
+   *  \param [in] io libev watcher
+   */
+  ev_io(factory &manager, ::bro::ev::io_t &&io)
+    : _factory(manager)
+    , _io(std::move(io)) {
+    _io->set_callback([this]() { handle_event(); });
+  }
+
+  ~ev_io() override {
+    // factory lists must not point on destroyed io
+    if (_in_deferred)
+      std::replace(_factory._deferred.begin(), _factory._deferred.end(), this, (ev_io *) nullptr);
+    if (_in_delayed)
+      std::replace(_factory._delayed.begin(), _factory._delayed.end(), this, (ev_io *) nullptr);
+  }
+
+  void start(int fd, callback_t cb) override {
+    _cb = std::move(cb);
+    start(fd);
+  }
+
+  void start(int fd) override {
+    if (_enabled && fd == _fd)
+      return;
+    _enabled = true;
+    if (_io->is_active()) {
+      if (fd == _fd) {
+        // watcher wasn't stopped yet. libev itself merges stop and start within one iteration and removes fd
+        // from epoll lazily, hence only restart after poll would cost epoll_ctl
+        if (_stop_iteration != _factory._iteration)
+          ++_factory._statistic._avoided_epoll_ctl;
+        return;
+      }
+      _io->stop();
+      ++_factory._statistic._interest_updates;
+    }
+    _fd = fd;
+    _io->start(fd);
+    ++_factory._statistic._interest_updates;
+  }
+
+  void stop() override {
+    if (_enabled)
+      _stop_iteration = _factory._iteration;
+    _enabled = false;
+    // io stays in lists of factory, but isn't called
+    _deferred = false;
+    _delayed = false;
+  }
+
+  void set_callback(callback_t cb) override { _cb = std::move(cb); }
+
+  bool is_active() const override { return _enabled; }
+
+  void defer(int /*fd*/, std::chrono::microseconds delay) override {
+    if (delay.count() <= 0) {
+      _deferred = true;
+      if (!std::exchange(_in_deferred, true))
+        _factory._deferred.push_back(this);
+      return;
+    }
+    _delayed = true;
+    _deadline = std::chrono::steady_clock::now() + delay;
+    if (!std::exchange(_in_delayed, true))
+      _factory._delayed.push_back(this);
+  }
+
+  /*! \brief call deferred callback (io is removed from deferred list of factory)
+   */
+  void call_deferred() {
+    _in_deferred = false;
+    if (!std::exchange(_deferred, false))
+      return;
+    ++_factory._statistic._deferred_calls;
+    _cb();
+  }
+
+  /*! \brief check io must leave delayed list of factory
+   *  \param [in] now current time
+   *  \return true if delay is expired or io was stopped
+   */
+  bool is_delay_expired(std::chrono::steady_clock::time_point now) const noexcept {
+    return !_delayed || now >= _deadline;
+  }
+
+  /*! \brief call delayed callback (io is removed from delayed list of factory)
+   */
+  void call_delayed() {
+    _in_delayed = false;
+    if (!std::exchange(_delayed, false))
+      return;
+    ++_factory._statistic._deferred_calls;
+    _cb();
+  }
+
+private:
+  /*! \brief handle event of watcher
+   */
+  void handle_event() {
+    if (_enabled) {
+      ++_factory._statistic._events;
+      _cb();
+      return;
+    }
+    // io was stopped by stream. now we really need to stop watcher
+    _io->stop();
+    ++_factory._statistic._interest_updates;
+  }
+
+  factory &_factory;                               ///< owning factory
+  ::bro::ev::io_t _io;                             ///< libev watcher
+  callback_t _cb;                                  ///< callback on event
+  std::chrono::steady_clock::time_point _deadline; ///< time of delayed call
+  uint64_t _stop_iteration{0};                     ///< iteration of factory when io was stopped
+  int _fd{-1};                                     ///< file descriptor of watcher
+  bool _enabled{false};                            ///< io is started by stream
+  bool _deferred{false};                           ///< io must be called at the end of iteration
+  bool _delayed{false};                            ///< io must be called after deadline
+  bool _in_deferred{false};                        ///< io is in deferred list of factory
+  bool _in_delayed{false};                         ///< io is in delayed list of factory
+};
+
 strm::stream_ptr factory::create_stream(strm::settings *stream_set) {
-#ifdef WITH_SCTP_SSL
-  if (auto *param = dynamic_cast<sctp::ssl::listen::settings *>(stream_set); param) {
-    auto sck = std::make_unique<sctp::ssl::listen::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<sctp::ssl::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<sctp::ssl::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-#endif // WITH_SCTP_SSL
-#ifdef WITH_SCTP
-  if (auto *param = dynamic_cast<sctp::listen::settings *>(stream_set); param) {
-    auto sck = std::make_unique<sctp::listen::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<sctp::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<sctp::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-#endif // WITH_SCTP
-#ifdef WITH_TCP_SSL
-  if (auto *param = dynamic_cast<tcp::ssl::listen::settings *>(stream_set); param) {
-    auto sck = std::make_unique<tcp::ssl::listen::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<tcp::ssl::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<tcp::ssl::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-#endif // WITH_TCP_SSL
-#ifdef WITH_UDP_SSL
-  if (auto *param = dynamic_cast<udp::ssl::listen::settings *>(stream_set); param) {
-    auto sck = std::make_unique<udp::ssl::listen::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<udp::ssl::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<udp::ssl::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-#endif // WITH_UDP_SSL
-  if (auto *param = dynamic_cast<udp::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<udp::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<tcp::send::settings *>(stream_set); param) {
-    auto sck = std::make_unique<tcp::send::stream>();
-    sck->init(param);
-    return sck;
-  }
-  if (auto *param = dynamic_cast<tcp::listen::settings *>(stream_set); param) {
-    auto sck = std::make_unique<tcp::listen::stream>();
-    sck->init(param);
-    return sck;
-  }
-  return nullptr;
+  return net::create_stream(stream_set);
 }
 
 void factory::bind(strm::stream_ptr &stream) {
-  if (auto *st = dynamic_cast<bro::net::send::stream *>(stream.get()); st) {
-    st->assign_events(_factory.generate_io(::bro::ev::io::type::e_read),
-                      _factory.generate_io(::bro::ev::io::type::e_write));
-  } else if (auto *st = dynamic_cast<bro::net::listen::stream *>(stream.get()); st) {
-    st->assign_event(_factory.generate_io(::bro::ev::io::type::e_read));
+  switch (get_stream_kind(stream.get())) {
+  case stream_kind::e_send: {
+    auto *st = static_cast<bro::net::send::stream *>(stream.get());
+    st->set_chunk_pool(&_chunks);
+    st->assign_events(std::make_unique<ev_io>(*this, _factory.generate_io(::bro::ev::io::type::e_read)),
+                      std::make_unique<ev_io>(*this, _factory.generate_io(::bro::ev::io::type::e_write)));
+    break;
+  }
+  case stream_kind::e_listen: {
+    auto *st = static_cast<bro::net::listen::stream *>(stream.get());
+    st->assign_event(std::make_unique<ev_io>(*this, _factory.generate_io(::bro::ev::io::type::e_read)));
+    break;
+  }
+  default:
+    break;
   }
 }
 
+relay_ptr factory::relay(strm::stream_ptr &&first, strm::stream_ptr &&second) {
+  for (auto const *st : {first.get(), second.get()}) {
+    if (!st || stream_kind::e_send != get_stream_kind(st) || strm::stream::state::e_established != st->get_state())
+      return nullptr;
+  }
+  auto take = [](strm::stream_ptr &st) {
+    auto deleter = st.get_deleter();
+    return std::unique_ptr<send::stream, strm::stream_deleter>(static_cast<send::stream *>(st.release()), deleter);
+  };
+  return std::make_unique<stream_relay>(take(first), take(second));
+}
+
 void factory::proceed() {
+  ++_iteration;
   _factory.proceed();
+  call_deferred();
+}
+
+void factory::call_deferred() {
+  // callbacks can defer io again (it is called in this loop) or destroy other io (entry is nullptr)
+  for (size_t i = 0; i < _deferred.size(); ++i) {
+    if (auto *io = _deferred[i]; io)
+      io->call_deferred();
+  }
+  _deferred.clear();
+
+  if (_delayed.empty())
+    return;
+  auto const now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < _delayed.size(); ++i) {
+    auto *io = _delayed[i];
+    if (!io || !io->is_delay_expired(now))
+      continue;
+    // callback can delay io again (it is appended to list)
+    _delayed[i] = nullptr;
+    io->call_delayed();
+  }
+  _delayed.erase(std::remove(_delayed.begin(), _delayed.end(), nullptr), _delayed.end());
 }
 
 } // namespace bro::net::ev
@@ -0,0 +1,123 @@
+#include <network/stream/factory_pool.h>
+
+namespace bro::net::ev {
+
+/*! \brief period of reactor load measurement
+ */
+static constexpr std::chrono::milliseconds load_measure_period(100);
+
+factory_pool::factory_pool(size_t reactors, std::chrono::microseconds idle_sleep)
+  : _idle_sleep(idle_sleep) {
+  _reactors.reserve(reactors ? reactors : 1);
+  for (size_t i = 0; i < (reactors ? reactors : 1); ++i)
+    _reactors.push_back(std::make_unique<reactor>());
+}
+
+factory_pool::~factory_pool() {
+  stop();
+  join();
+}
+
+bool factory_pool::start() {
+  if (_running.exchange(true, std::memory_order_acq_rel))
+    return false;
+  for (auto &r : _reactors) {
+    // previous run could be stopped without join
+    if (r->_thread.joinable())
+      r->_thread.join();
+    r->_thread = std::thread(&factory_pool::run, this, std::ref(*r));
+  }
+  return true;
+}
+
+void factory_pool::stop() noexcept {
+  _running.store(false, std::memory_order_release);
+}
+
+void factory_pool::join() {
+  for (auto &r : _reactors) {
+    if (r->_thread.joinable())
+      r->_thread.join();
+  }
+}
+
+size_t factory_pool::select_reactor(policy pol, size_t hash) noexcept {
+  switch (pol) {
+  case policy::e_hash:
+    return hash % _reactors.size();
+  case policy::e_least_loaded: {
+    // start from next reactor, hence reactors with the same load are used in turn
+    size_t const start = _next.fetch_add(1, std::memory_order_relaxed);
+    size_t res = start % _reactors.size();
+    uint32_t min_load = get_load(res);
+    for (size_t i = 1; i < _reactors.size() && min_load; ++i) {
+      size_t const idx = (start + i) % _reactors.size();
+      if (uint32_t const load = get_load(idx); load < min_load) {
+        min_load = load;
+        res = idx;
+      }
+    }
+    return res;
+  }
+  case policy::e_round_robin:
+    [[fallthrough]];
+  default:
+    break;
+  }
+  return _next.fetch_add(1, std::memory_order_relaxed) % _reactors.size();
+}
+
+void factory_pool::execute(size_t reactor, task_t task) {
+  auto &r = *_reactors[reactor % _reactors.size()];
+  std::lock_guard<std::mutex> lg(r._guard);
+  r._tasks.push_back(std::move(task));
+  r._has_tasks.store(true, std::memory_order_release);
+}
+
+void factory_pool::run(reactor &r) {
+  using clock = std::chrono::steady_clock;
+  std::vector<task_t> tasks;
+  auto period_start = clock::now();
+  clock::duration busy{0};
+  while (_running.load(std::memory_order_acquire)) {
+    auto const begin = clock::now();
+    bool const has_tasks = r._has_tasks.load(std::memory_order_acquire);
+    if (has_tasks) {
+      {
+        std::lock_guard<std::mutex> lg(r._guard);
+        tasks.swap(r._tasks);
+        r._has_tasks.store(false, std::memory_order_relaxed);
+      }
+      for (auto &task : tasks)
+        task(r._manager);
+      tasks.clear();
+    }
+    // events and deferred calls of factory show that reactor isn't idle
+    auto const &stat = r._manager.get_statistic();
+    uint64_t const handled = stat._events + stat._deferred_calls;
+    r._manager.proceed();
+    bool const has_events = handled != stat._events + stat._deferred_calls;
+
+    auto const end = clock::now();
+    busy += end - begin;
+    if (end - period_start >= load_measure_period) {
+      r._load.store(uint32_t(busy * 1000 / (end - period_start)), std::memory_order_relaxed);
+      busy = clock::duration{0};
+      period_start = end;
+    }
+
+    if (!has_tasks && !has_events && _idle_sleep.count())
+      std::this_thread::sleep_for(_idle_sleep);
+  }
+
+  // execute tasks passed before stop (for instance streams cleanup)
+  {
+    std::lock_guard<std::mutex> lg(r._guard);
+    tasks.swap(r._tasks);
+    r._has_tasks.store(false, std::memory_order_relaxed);
+  }
+  for (auto &task : tasks)
+    task(r._manager);
+}
+
+} // namespace bro::net::ev
@@ -0,0 +1,55 @@
+#include <network/platforms/system.h>
+#include <network/stream/listen/shards.h>
+
+namespace bro::net::listen {
+
+bool shards::init(std::vector<ev::factory *> const &factories,
+                  settings *listen_set,
+                  std::vector<settings::in_conn_handler_data_cb> const &shard_data) {
+  if (!shard_data.empty() && shard_data.size() != factories.size()) {
+    append_error(_err, "number of shards user data doesn't match number of factories");
+    return false;
+  }
+
+  _streams.clear();
+  _streams.reserve(factories.size());
+  bool const reuse_port = listen_set->_reuse_port;
+  auto const handler_data = listen_set->_in_conn_handler_data;
+  listen_set->_reuse_port = true;
+  bool res = true;
+  for (size_t i = 0; i < factories.size(); ++i) {
+    // settings are copied on creation, hence we can change user data for every shard
+    if (!shard_data.empty())
+      listen_set->_in_conn_handler_data = shard_data[i];
+    auto stream = factories[i]->create_stream(listen_set);
+    if (!stream || !stream->is_active()) {
+      append_error(_err,
+                   "couldn't create listen shard " + std::to_string(i)
+                     + (stream ? ", cause - " + stream->get_error_description() : std::string()));
+      res = false;
+      break;
+    }
+    factories[i]->bind(stream);
+    _streams.push_back(std::move(stream));
+  }
+  listen_set->_reuse_port = reuse_port;
+  listen_set->_in_conn_handler_data = handler_data;
+  if (!res)
+    _streams.clear();
+  return res;
+}
+
+statistic const &shards::get_statistic(size_t shard) const {
+  return *static_cast<statistic const *>(_streams[shard]->get_statistic());
+}
+
+statistic shards::get_statistic() const {
+  statistic overall;
+  if (!_streams.empty())
+    overall._reset_time = get_statistic(0)._reset_time;
+  for (size_t i = 0; i < _streams.size(); ++i)
+    overall += get_statistic(i);
+  return overall;
+}
+
+} // namespace bro::net::listen
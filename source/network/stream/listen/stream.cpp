@@ -1,11 +1,35 @@
 #include <network/stream/listen/settings.h>
 #include <network/stream/listen/stream.h>
 #include <network/stream/send/settings.h>
+#include <netinet/in.h>
+#include <algorithm>
 
 namespace bro::net::listen {
 
+static bool is_wildcard_address(proto::ip::full_address const &addr) {
+  switch (addr.get_address().get_version()) {
+  case proto::ip::address::version::e_v4: {
+    sockaddr_in const native = addr.to_native_v4();
+    return INADDR_ANY == native.sin_addr.s_addr || 0 == native.sin_port;
+  }
+  case proto::ip::address::version::e_v6: {
+    sockaddr_in6 const native = addr.to_native_v6();
+    return IN6_IS_ADDR_UNSPECIFIED(&native.sin6_addr) || 0 == native.sin6_port;
+  }
+  default:
+    break;
+  }
+  return true;
+}
+
 stream::~stream() {
+  // stream is destroyed by incoming connection callback
+  if (_destroyed)
+    *_destroyed = true;
   stream::cleanup();
+  // accepted streams can outlive listen stream. pool is freed with last of them
+  if (_streams)
+    _streams->detach();
 }
 
 ssize_t stream::send(std::byte const * /*data*/, size_t /*data_size*/) {
@@ -25,7 +49,7 @@ bool stream::is_active() const {
   return get_state() == state::e_wait;
 }
 
-bool stream::fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &new_stream) {
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &new_stream) {
   auto *n_stream = (bro::net::stream *) (new_stream.get());
   if (!result) {
     _statistic._failed_to_accept_connections++;
@@ -35,12 +59,27 @@ bool stream::fill_send_stream(accept_connection_res const &result, std::unique_p
 
   auto *set = (bro::net::send::settings *) new_stream->get_settings();
   set->_peer_addr = result->_peer_addr;
-  set->_self_addr = result->_self_address;
+  // for wildcard listen address self address is requested on demand (send::stream::get_self_address)
+  auto *listen_set = (bro::net::listen::settings *) get_settings();
+  if (!is_wildcard_address(listen_set->_listen_address))
+    set->_self_addr = listen_set->_listen_address;
+  set->_high_watermark = listen_set->_send_high_watermark;
+  set->_low_watermark = listen_set->_send_low_watermark;
+  set->_cork = listen_set->_send_cork;
+  set->_cork_max_delay = listen_set->_send_cork_max_delay;
+  set->_zero_copy = listen_set->_send_zero_copy;
+  set->_zero_copy_threshold = listen_set->_send_zero_copy_threshold;
   n_stream->_file_descr = result->_client_fd;
-  if (!n_stream->set_socket_options()) {
+  // non blocking mode is already set by accept
+  if (!n_stream->set_socket_options(true)) {
     _statistic._failed_to_accept_connections++;
     return false;
   }
+  if (set->_zero_copy && !enable_zero_copy(n_stream->get_fd(), n_stream->get_error_description())) {
+    _statistic._failed_to_accept_connections++;
+    n_stream->set_connection_state(state::e_failed);
+    return false;
+  }
   _statistic._success_accept_connections++;
   n_stream->set_connection_state(state::e_established);
   return true;
@@ -50,15 +89,49 @@ void stream::handle_incoming_connection() {
   auto *set = (bro::net::listen::settings *) get_settings();
   if (!set->_proc_in_conn)
     return;
+  ++_statistic._accept_events;
   auto addr_t = set->_listen_address.get_address().get_version();
-  auto sck{generate_send_stream()};
-  (void) fill_send_stream(accept_connection(addr_t, _file_descr, sck->get_error_description()), sck);
-  set->_proc_in_conn(std::move(sck), set->_in_conn_handler_data);
+  // accept all pending connections, but no more than budget. other streams must not starve
+  for (uint16_t i = 0; i < std::max<uint16_t>(set->_accept_budget, 1); ++i) {
+    if (!_accept_stream)
+      _accept_stream = generate_send_stream();
+    auto &err = _accept_stream->get_error_description();
+    accept_connection_res res;
+    if (_in_connections->is_completion()) {
+      // connection is already accepted by reactor (always in non blocking mode)
+      int const client_fd = _in_connections->accept();
+      if (-1 == client_fd && 0 == errno)
+        return;
+      if (-1 == client_fd)
+        append_error(err, "coulnd't accept connection");
+      else
+        res = accepted_connection(addr_t, client_fd, err);
+    } else {
+      bool const non_blocking = ((net::settings const *) _accept_stream->get_settings())->_non_blocking_socket;
+      res = accept_connection(addr_t, _file_descr, non_blocking, err);
+      if (!res && err.empty()) {
+        accept_would_block();
+        return;
+      }
+    }
+    (void) fill_send_stream(res, _accept_stream);
+    bool destroyed = false;
+    _destroyed = &destroyed;
+    set->_proc_in_conn(std::move(_accept_stream), set->_in_conn_handler_data);
+    // callback can destroy listen stream (shutdown)
+    if (destroyed)
+      return;
+    _destroyed = nullptr;
+    // hard error (EMFILE, ENFILE, ENOBUFS...) repeats for every pending connection. retry on next event
+    if (!res)
+      return;
+  }
+  ++_statistic._accept_budget_exhausted;
 }
 
-void stream::assign_event(bro::ev::io_t &&in_conn) {
+void stream::assign_event(net::io_ptr &&in_conn) {
   _in_connections = std::move(in_conn);
-  _in_connections->start(get_fd(), std::function<void()>(std::bind(&stream::handle_incoming_connection, this)));
+  _in_connections->start(get_fd(), [this]() { handle_incoming_connection(); });
 }
 
 void stream::cleanup() {
@@ -0,0 +1,68 @@
+#include <network/stream/listen/stream_pool.h>
+#include <new>
+
+namespace bro::net::listen {
+
+stream_pool::stream_pool(size_t object_size, size_t max_idle)
+  : _object_size(object_size)
+  , _max_idle(max_idle) {
+  // recycle never allocates
+  _idle.reserve(max_idle);
+}
+
+stream_pool::~stream_pool() {
+  for (auto *block : _idle)
+    ::operator delete(block);
+}
+
+void *stream_pool::acquire(bool &reused) {
+  {
+    std::lock_guard<std::mutex> lg(_guard);
+    reused = !_idle.empty();
+    if (reused) {
+      void *block = _idle.back();
+      _idle.pop_back();
+      ++_borrowed;
+      return block;
+    }
+  }
+  void *block = ::operator new(_object_size);
+  std::lock_guard<std::mutex> lg(_guard);
+  ++_borrowed;
+  return block;
+}
+
+void stream_pool::detach() noexcept {
+  std::unique_lock<std::mutex> lg(_guard);
+  _detached = true;
+  for (auto *block : _idle)
+    ::operator delete(block);
+  _idle.clear();
+  if (_borrowed)
+    return;
+  lg.unlock();
+  delete this;
+}
+
+void stream_pool::release(void *block) noexcept {
+  std::unique_lock<std::mutex> lg(_guard);
+  --_borrowed;
+  if (!_detached && _idle.size() < _max_idle) {
+    _idle.push_back(block);
+    return;
+  }
+  ::operator delete(block);
+  if (!_detached || _borrowed)
+    return;
+  lg.unlock();
+  delete this;
+}
+
+void stream_pool::recycle(void *pool, strm::stream *st) noexcept {
+  // memory block starts with most derived object
+  void *block = dynamic_cast<void *>(st);
+  st->~stream();
+  static_cast<stream_pool *>(pool)->release(block);
+}
+
+} // namespace bro::net::listen
@@ -0,0 +1,130 @@
+#ifdef WITH_TCP_SSL
+#include <network/tcp/ssl/listen/stream.h>
+#include <network/tcp/ssl/send/stream.h>
+#endif // WITH_TCP_SSL
+#ifdef WITH_SCTP
+#include <network/sctp/listen/stream.h>
+#include <network/sctp/send/stream.h>
+#endif // WITH_SCTP
+#ifdef WITH_SCTP_SSL
+#include <network/sctp/ssl/listen/stream.h>
+#include <network/sctp/ssl/send/stream.h>
+#endif // WITH_SCTP_SSL
+#ifdef WITH_UDP_SSL
+#include <network/udp/ssl/listen/stream.h>
+#include <network/udp/ssl/send/stream.h>
+#endif // WITH_UDP_SSL
+#include <network/stream/factory.h>
+#include <network/stream/registry.h>
+#include <network/tcp/listen/stream.h>
+#include <network/tcp/send/stream.h>
+#include <network/udp/send/stream.h>
+#include <unordered_map>
+#include <vector>
+
+namespace bro::net {
+
+/**
+ * \brief registered stream type
+ */
+struct stream_type {
+  stream_creator _creator;   ///< create and init stream
+  settings_matcher _matcher; ///< check settings are derived from registered type
+  stream_kind _kind;         ///< kind of stream
+};
+
+/**
+ * \brief registered stream types
+ */
+struct registry {
+  /*! \brief add stream type
+   *  \param [in] settings_type type of settings
+   *  \param [in] type stream type
+   */
+  void add(std::type_index settings_type, stream_type const &type) {
+    _types[settings_type] = type;
+    // the last registered type is more specific (derived settings are registered after base ones)
+    _chain.insert(_chain.begin(), type);
+  }
+
+  /*! \brief find stream type for settings
+   *  \param [in] stream_set pointer on settings
+   *  \return stream type or nullptr
+   */
+  stream_type const *find(strm::settings const *stream_set) const {
+    if (auto it = _types.find(typeid(*stream_set)); it != _types.end())
+      return &it->second;
+    for (auto const &type : _chain) {
+      if (type._matcher(stream_set))
+        return &type;
+    }
+    return nullptr;
+  }
+
+  std::unordered_map<std::type_index, stream_type> _types; ///< stream types by exact type of settings
+  std::vector<stream_type> _chain;                         ///< stream types for derived settings (specific first)
+};
+
+/*! \brief add built-in stream type
+ */
+template <typename Settings, typename Stream> static void add_builtin(registry &reg) {
+  reg.add(typeid(Settings),
+          {&create_stream_of_type<Settings, Stream>, &is_settings_of_type<Settings>, stream_kind_of<Stream>()});
+}
+
+/*! \brief get registered stream types (built-in types are registered on first call)
+ */
+static registry &get_registry() {
+  static registry reg = []() {
+    registry builtin;
+    // base settings first, derived ones are checked before them
+    add_builtin<tcp::listen::settings, tcp::listen::stream>(builtin);
+    add_builtin<tcp::send::settings, tcp::send::stream>(builtin);
+    add_builtin<udp::send::settings, udp::send::stream>(builtin);
+#ifdef WITH_UDP_SSL
+    add_builtin<udp::ssl::send::settings, udp::ssl::send::stream>(builtin);
+    add_builtin<udp::ssl::listen::settings, udp::ssl::listen::stream>(builtin);
+#endif // WITH_UDP_SSL
+#ifdef WITH_TCP_SSL
+    add_builtin<tcp::ssl::send::settings, tcp::ssl::send::stream>(builtin);
+    add_builtin<tcp::ssl::listen::settings, tcp::ssl::listen::stream>(builtin);
+#endif // WITH_TCP_SSL
+#ifdef WITH_SCTP
+    add_builtin<sctp::send::settings, sctp::send::stream>(builtin);
+    add_builtin<sctp::listen::settings, sctp::listen::stream>(builtin);
+#endif // WITH_SCTP
+#ifdef WITH_SCTP_SSL
+    add_builtin<sctp::ssl::send::settings, sctp::ssl::send::stream>(builtin);
+    add_builtin<sctp::ssl::listen::settings, sctp::ssl::listen::stream>(builtin);
+#endif // WITH_SCTP_SSL
+    return builtin;
+  }();
+  return reg;
+}
+
+void register_stream_type(std::type_index settings_type, stream_creator creator, settings_matcher matcher,
+                          stream_kind kind) {
+  get_registry().add(settings_type, {creator, matcher, kind});
+}
+
+strm::stream_ptr create_stream(strm::settings *stream_set) {
+  if (!stream_set)
+    return nullptr;
+  auto const *type = get_registry().find(stream_set);
+  return type ? type->_creator(stream_set) : nullptr;
+}
+
+stream_kind get_stream_kind(strm::stream const *stream) {
+  if (!stream)
+    return stream_kind::e_unknown;
+  if (auto const *type = get_registry().find(stream->get_settings()); type)
+    return type->_kind;
+  // stream with not registered settings
+  if (dynamic_cast<send::stream const *>(stream))
+    return stream_kind::e_send;
+  if (dynamic_cast<listen::stream const *>(stream))
+    return stream_kind::e_listen;
+  return stream_kind::e_unknown;
+}
+
+} // namespace bro::net
@@ -0,0 +1,285 @@
+#include <network/stream/relay.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace bro::net {
+
+/*! \brief max number of reads per read event. other streams must not starve
+ */
+static constexpr size_t relay_budget = 16;
+
+/*! \brief size of pipe between spliced sockets (if system allows)
+ */
+static constexpr int relay_pipe_size = 256 * 1024;
+
+/*! \brief size of reactor buffer for copied data
+ */
+static constexpr size_t relay_buffer_size = 64 * 1024;
+
+stream_relay::stream_relay(std::unique_ptr<send::stream, strm::stream_deleter> &&first,
+                           std::unique_ptr<send::stream, strm::stream_deleter> &&second)
+  : _first(std::move(first))
+  , _second(std::move(second)) {
+  _forward._from = _first.get();
+  _forward._to = _second.get();
+  _forward._bytes = &_statistic._first_to_second;
+  _backward._from = _second.get();
+  _backward._to = _first.get();
+  _backward._bytes = &_statistic._second_to_first;
+
+  // buffered data must be sent before relayed data, hence it isn't spliced
+  _spliced = is_splice_supported(_first.get()) && is_splice_supported(_second.get())
+             && _first->is_send_queue_empty() && _second->is_send_queue_empty();
+  if (!start(_forward) || !start(_backward))
+    finish();
+}
+
+stream_relay::~stream_relay() {
+  for (auto *dir : {&_forward, &_backward}) {
+    for (int fd : dir->_pipe) {
+      if (-1 != fd)
+        ::close(fd);
+    }
+  }
+}
+
+void stream_relay::set_finished_cb(finished_cb cb, std::any param) {
+  _finished_cb = cb;
+  _param_finished_cb = param;
+}
+
+bool stream_relay::is_splice_supported(send::stream *st) noexcept {
+  return st->is_splice_supported() && !st->is_message_oriented() && !st->is_received_by_reactor();
+}
+
+bool stream_relay::start(direction &dir) {
+  if (!dir._from->_read || !dir._to->_write) {
+    _err = "stream isn't bound to factory";
+    return false;
+  }
+  dir._from->set_state_changed_cb(
+    [this, &dir](strm::stream *st, std::any) {
+      if (!st->is_active())
+        stream_closed(dir);
+    },
+    {});
+  if (!_spliced) {
+    // streams which support it are half closed by peer (other direction still works)
+    dir._from->_keep_open_on_eof = true;
+    dir._from->set_received_data_cb([this, &dir](strm::stream *, std::any) { copy_readable(dir); }, {});
+    dir._to->set_send_queue_drained_cb([this, &dir](strm::stream *, std::any) { copy_drained(dir); }, {});
+    return true;
+  }
+
+  int fds[2];
+  if (-1 == ::pipe2(fds, O_NONBLOCK | O_CLOEXEC)) {
+    _err = "couldn't create pipe";
+    errno = 0;
+    return false;
+  }
+  dir._pipe = {fds[0], fds[1]};
+  // bigger pipe moves more data per splice. default size is used if it isn't allowed
+  if (-1 == ::fcntl(fds[1], F_SETPIPE_SZ, relay_pipe_size))
+    errno = 0;
+  dir._from->set_received_data_cb([this, &dir](strm::stream *, std::any) { splice_readable(dir); }, {});
+  dir._to->_write->set_callback([this, &dir]() { splice_writable(dir); });
+  return true;
+}
+
+void stream_relay::splice_readable(direction &dir) {
+  for (size_t i = 0; i < relay_budget; ++i) {
+    ssize_t const moved = ::splice(dir._from->get_fd(), nullptr, dir._pipe[1], nullptr, relay_pipe_size,
+                                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (moved > 0) {
+      dir._in_pipe += (size_t) moved;
+      if (!flush_pipe(dir))
+        return;
+      if (dir._in_pipe) {
+        // other side doesn't accept data. stop reading till pipe is drained
+        dir._from->_read->stop();
+        dir._to->_write->start(dir._to->get_fd());
+        return;
+      }
+      continue;
+    }
+
+    if (0 == moved) {
+      // connection is closed by peer. other side is half closed after pipe is drained
+      dir._eof = true;
+      dir._from->_read->stop();
+      if (!dir._in_pipe)
+        close_direction(dir);
+      return;
+    }
+
+    if (EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+    if (EAGAIN == errno || EWOULDBLOCK == errno) {
+      errno = 0;
+      dir._from->receive_would_block();
+      return;
+    }
+    errno = 0;
+    fail("couldn't splice data from socket");
+    return;
+  }
+}
+
+void stream_relay::splice_writable(direction &dir) {
+  if (!flush_pipe(dir) || dir._in_pipe)
+    return;
+  dir._to->_write->stop();
+  if (dir._eof) {
+    close_direction(dir);
+    return;
+  }
+  dir._from->_read->start(dir._from->get_fd());
+}
+
+bool stream_relay::flush_pipe(direction &dir) {
+  while (dir._in_pipe) {
+    ssize_t const moved = ::splice(dir._pipe[0], nullptr, dir._to->get_fd(), nullptr, dir._in_pipe,
+                                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (moved > 0) {
+      dir._in_pipe -= (size_t) moved;
+      *dir._bytes += (uint64_t) moved;
+      continue;
+    }
+    if (-1 == moved && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+    if (-1 == moved && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      errno = 0;
+      dir._to->send_would_block();
+      return true;
+    }
+    errno = 0;
+    fail("couldn't splice data into socket");
+    return false;
+  }
+  return true;
+}
+
+void stream_relay::copy_readable(direction &dir) {
+  // buffer of reactor (every reactor is a thread). not sent data is kept in send buffer of stream (pooled chunks)
+  static thread_local std::vector<std::byte> reactor_buffer(relay_buffer_size);
+  for (size_t i = 0; i < relay_budget; ++i) {
+    ssize_t const rec = dir._from->receive(reactor_buffer.data(), reactor_buffer.size());
+    // failed stream is handled by state callback
+    if (rec <= 0) {
+      if (0 == rec && dir._from->_peer_closed)
+        peer_closed(dir);
+      return;
+    }
+
+    // failed send calls state callback of stream (relay can be finished before send returns)
+    _sending_to = dir._to;
+    ssize_t const sent = dir._to->send(reactor_buffer.data(), (size_t) rec);
+    _sending_to = nullptr;
+    if (send::send_queue_full == sent) {
+      // data is already read from other side. high watermark of stream is below relay buffer, keep data anyway
+      iovec const vec{reactor_buffer.data(), (size_t) rec};
+      dir._to->buffer_message(&vec, 1, 0);
+    } else if (sent < 0) {
+      if (!_finished)
+        fail(get_send_error(dir._to));
+      return;
+    }
+    *dir._bytes += (uint64_t) rec;
+    if (dir._to->get_send_queue_size() > dir._to->_low_watermark) {
+      // other side doesn't accept data. stop reading till send buffer is drained (already received data is kept)
+      dir._from->_read->pause();
+      dir._to->_send_queue_full = true;
+      return;
+    }
+  }
+}
+
+void stream_relay::copy_drained(direction &dir) {
+  if (_finished)
+    return;
+  if (!dir._eof) {
+    dir._from->_read->resume(dir._from->get_fd());
+    return;
+  }
+  if (dir._to->is_send_queue_empty()) {
+    close_direction(dir);
+    return;
+  }
+  // callback is called once. wait till all data is delivered
+  dir._to->_send_queue_full = true;
+}
+
+void stream_relay::peer_closed(direction &dir) {
+  dir._eof = true;
+  if (dir._to->is_send_queue_empty()) {
+    close_direction(dir);
+    return;
+  }
+  // callback is called once. wait till all data is delivered
+  dir._to->_send_queue_full = true;
+}
+
+std::string stream_relay::get_send_error(send::stream *st) {
+  return "couldn't send relayed data - " + st->get_error_description();
+}
+
+void stream_relay::stream_closed(direction &dir) {
+  if (_finished)
+    return;
+  // error is set before finished callback is called
+  if (dir._from == _sending_to)
+    _err = get_send_error(dir._from);
+  // failed stream can't receive data of other direction too
+  auto &other = &dir == &_forward ? _backward : _forward;
+  other._done = true;
+  if (other._from->_read)
+    other._from->_read->stop();
+  if (dir._eof) {
+    // direction is already closed by peer. relay is finished after its data is delivered
+    if (dir._done)
+      finish();
+    return;
+  }
+  dir._eof = true;
+  if (_spliced || dir._to->is_send_queue_empty()) {
+    close_direction(dir);
+    return;
+  }
+  dir._to->_send_queue_full = true;
+}
+
+void stream_relay::close_direction(direction &dir) {
+  dir._done = true;
+  // ssl streams aren't half closed (it would break session)
+  if (dir._to->is_splice_supported() && strm::stream::state::e_established == dir._to->get_state())
+    ::shutdown(dir._to->get_fd(), SHUT_WR);
+  if (_forward._done && _backward._done)
+    finish();
+}
+
+void stream_relay::fail(std::string const &err) {
+  _err = err;
+  finish();
+}
+
+void stream_relay::finish() {
+  if (_finished)
+    return;
+  _finished = true;
+  for (auto *st : {_first.get(), _second.get()}) {
+    if (st->_read)
+      st->_read->stop();
+    if (st->_write && _spliced)
+      st->_write->stop();
+  }
+  if (_finished_cb)
+    _finished_cb(this, _param_finished_cb);
+}
+
+} // namespace bro::net
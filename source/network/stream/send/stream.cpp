@@ -1,10 +1,30 @@
 #include <network/stream/send/settings.h>
 #include <network/platforms/system.h>
 #include <network/stream/send/stream.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
 
 namespace bro::net::send {
 
+/*! \brief max number of reads per read event in received view mode. other streams must not starve
+ */
+static constexpr size_t receive_view_budget = 16;
+
+/*! \brief max number of buffer segments gathered into one write in cork mode
+ */
+static constexpr size_t cork_max_segments = 64;
+
+/*! \brief size of one read of file which is sent through user space
+ */
+static constexpr size_t file_read_size = 64 * 1024;
+
 stream::~stream() {
+  // stream is destroyed by own callback
+  if (_destroyed)
+    *_destroyed = true;
   stream::cleanup();
 }
 
@@ -15,16 +35,24 @@ void stream::stop_events() {
     _write->stop();
 }
 
-void stream::assign_events(bro::ev::io_t &&read, bro::ev::io_t &&write) {
-  _buffer_send = ((net::send::settings *) (get_settings()))->_buffer_send;
+void stream::assign_events(net::io_ptr &&read, net::io_ptr &&write) {
+  auto const *set = (net::send::settings *) (get_settings());
+  _buffer_send = set->_buffer_send;
+  _high_watermark = set->_high_watermark;
+  _low_watermark = std::min(set->_low_watermark, set->_high_watermark);
+  _cork = set->_cork;
+  _cork_max_delay = _cork && set->_cork_max_delay ? *set->_cork_max_delay : std::chrono::microseconds{0};
+  _message_oriented = is_message_oriented();
+  if (set->_zero_copy)
+    _zero_copy_threshold = set->_zero_copy_threshold;
   _read = std::move(read);
   _write = std::move(write);
   if (state::e_established == get_state()) {
-    _read->start(get_fd(), std::function<void()>(std::bind(&stream::receive_data, this)));
-    _write->set_callback(std::function<void()>(std::bind(&stream::send_buffered_data, this)));
+    _read->start(get_fd(), [this]() { receive_data(); });
+    _write->set_callback([this]() { send_buffered_data(); });
     enable_send_cb();
   } else {
-    _write->start(get_fd(), std::function<void()>(std::bind(&stream::connection_established, this)));
+    _write->start(get_fd(), [this]() { connection_established(); });
   }
 }
 
@@ -41,23 +69,37 @@ bool stream::connection_established() {
     return false;
   }
 
+  // start read event first. file descriptor stays in reactor while write event is restarted
+  _read->start(get_fd(), [this]() { receive_data(); });
   disable_send_cb();
-  _write->set_callback(std::function<void()>(std::bind(&stream::send_buffered_data, this)));
+  _write->set_callback([this]() { send_buffered_data(); });
   enable_send_cb();
-  _read->start(get_fd(), std::function<void()>(std::bind(&stream::receive_data, this)));
   return true;
 }
 
 ssize_t stream::send(std::byte const *data, size_t data_size) {
-  // check stream state
+  iovec const vec{const_cast<std::byte *>(data), data_size};
+  return send_user_data(&vec, 1, data_size, [&]() { return send_data(data, data_size); });
+}
+
+ssize_t stream::sendv(iovec const *vec, size_t count) {
+  return send_user_data(vec, count, strm::get_iovec_size(vec, count), [&]() { return send_data_v(vec, count); });
+}
+
+ssize_t stream::send_file(int file_fd, off_t offset, size_t size) {
+  _last_zero_copy_id.reset();
+  // file can't be split on messages
+  if (is_message_oriented())
+    return -1;
   switch (get_state()) {
   case state::e_established:
     break;
   case state::e_wait: {
     if (!_buffer_send)
       return 0;
-    _send_buffer.append(data, data_size);
-    return data_size;
+    if (is_over_high_watermark(size))
+      return send_queue_full;
+    return queue_file(file_fd, offset, size) ? (ssize_t) size : -1;
   }
   case state::e_failed:
     [[fallthrough]];
@@ -68,21 +110,103 @@ ssize_t stream::send(std::byte const *data, size_t data_size) {
     break;
   }
 
-  // check buffer is not empty
-  if (!_send_buffer.is_empty()) {
-    _send_buffer.append(data, data_size);
-    return data_size;
+  if (!is_send_queue_empty() || _cork) {
+    // queued file is counted in send queue like buffered data
+    if (is_over_high_watermark(size))
+      return send_queue_full;
+    if (!queue_file(file_fd, offset, size))
+      return -1;
+    // corked stream is flushed by reactor. otherwise write event is already waited
+    if (_cork && _send_buffer.is_empty() && 1 == _files.size())
+      _write->defer(get_fd(), {});
+    return size;
   }
 
-  ssize_t sent = send_data(data, data_size);
-  if (!_buffer_send)
+  ssize_t sent = send_file_data(file_fd, offset, size);
+  if (!_buffer_send || sent < 0 || (size_t) sent == size)
     return sent;
-  if (sent >= 0 && (size_t) sent != data_size) {
-    _send_buffer.append(data + sent, data_size - sent);
-    enable_send_cb();
-    return data_size;
+  // socket buffer is full. send rest on write event
+  if (!queue_file(file_fd, offset + sent, size - (size_t) sent))
+    return -1;
+  enable_send_cb();
+  return size;
+}
+
+ssize_t stream::send_file_data(int file_fd, off_t offset, size_t size) {
+  // buffer of reactor (every reactor is a thread)
+  static thread_local std::vector<std::byte> file_buffer(file_read_size);
+  while (true) {
+    ssize_t const rec = ::pread(file_fd, file_buffer.data(), std::min(size, file_buffer.size()), offset);
+    if (rec > 0)
+      return send_data(file_buffer.data(), (size_t) rec);
+    if (0 == size)
+      return 0;
+    if (-1 == rec && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+    set_detailed_error(rec ? "couldn't read file" : "file is shorter than requested size");
+    errno = 0;
+    return -1;
+  }
+}
+
+bool stream::queue_file(int file_fd, off_t offset, size_t size) {
+  if (!size)
+    return true;
+  int const fd = ::fcntl(file_fd, F_DUPFD_CLOEXEC, 0);
+  if (-1 == fd) {
+    set_detailed_error("couldn't duplicate file descriptor");
+    errno = 0;
+    return false;
+  }
+  // buffered bytes which aren't placed before other files
+  size_t preceding = _send_buffer.size();
+  for (auto const &file : _files)
+    preceding -= file._preceding;
+  _files.push_back({preceding, size, offset, fd});
+  _queued_file_size += size;
+  return true;
+}
+
+ssize_t stream::send_data_v(iovec const *vec, size_t count) {
+  ssize_t overall{0};
+  for (size_t i = 0; i < count; ++i) {
+    ssize_t const sent = send_data(static_cast<std::byte const *>(vec[i].iov_base), vec[i].iov_len);
+    if (sent < 0)
+      return overall ? overall : sent;
+    overall += sent;
+    if ((size_t) sent != vec[i].iov_len)
+      break;
+  }
+  return overall;
+}
+
+void stream::buffer_message(iovec const *vec, size_t count, size_t skip) {
+  append_to_send_buffer(vec, count, skip);
+  // message oriented protocols never send part of message, hence skip is always 0 for them
+  if (_message_oriented)
+    _buffered_messages.push_back(strm::get_iovec_size(vec, count) - skip);
+}
+
+void stream::clear_send_buffer() {
+  _send_buffer.clear();
+  _buffered_messages.clear();
+  for (auto const &file : _files)
+    ::close(file._fd);
+  _files.clear();
+  _queued_file_size = 0;
+}
+
+void stream::append_to_send_buffer(iovec const *vec, size_t count, size_t skip) {
+  for (size_t i = 0; i < count; ++i) {
+    if (skip >= vec[i].iov_len) {
+      skip -= vec[i].iov_len;
+      continue;
+    }
+    _send_buffer.append(static_cast<std::byte const *>(vec[i].iov_base) + skip, vec[i].iov_len - skip);
+    skip = 0;
   }
-  return sent;
 }
 
 void stream::set_received_data_cb(strm::received_data_cb cb, std::any user_data) {
@@ -96,7 +220,72 @@ void stream::set_send_data_cb(strm::received_data_cb cb, std::any param) {
   if (_send_data_cb)
     _write->start(get_fd(), [&]() { _send_data_cb(this, _param_send_data_cb); });
   else
-    _write->stop();
+    restore_send_cb();
+}
+
+void stream::set_handler(strm::stream_handler *handler, bool writable_events) {
+  net::stream::set_handler(handler, writable_events);
+  if (!_write)
+    return;
+  if (handler && writable_events) {
+    _notify_writable = true;
+    _write->start(get_fd(), [this]() { notify_writable(); });
+  } else if (std::exchange(_notify_writable, false)) {
+    restore_send_cb();
+  }
+}
+
+void stream::notify_writable() {
+  if (auto *handler = get_handler(); handler)
+    handler->on_writable(this);
+}
+
+void stream::restore_send_cb() {
+  // connection isn't established yet. write event reports connection
+  if (state::e_wait == get_state()) {
+    _write->start(get_fd(), [this]() { connection_established(); });
+    return;
+  }
+  _write->set_callback([this]() { send_buffered_data(); });
+  if (is_send_queue_empty())
+    disable_send_cb();
+  else
+    enable_send_cb();
+}
+
+void stream::set_received_view_cb(received_view_cb cb, std::any param) {
+  _received_view_cb = cb;
+  _param_received_view_cb = param;
+  _unconsumed.clear();
+  if (!_received_view_cb) {
+    set_received_data_cb(nullptr, {});
+    return;
+  }
+  set_received_data_cb([this](strm::stream *, std::any) { receive_view(); }, {});
+}
+
+void stream::set_chunk_pool(chunk_pool *pool) {
+  _send_buffer.set_pool(pool);
+  _unconsumed.set_pool(pool);
+}
+
+void stream::set_send_queue_drained_cb(strm::send_data_cb cb, std::any param) {
+  _send_queue_drained_cb = cb;
+  _param_send_queue_drained_cb = param;
+}
+
+void stream::set_zero_copy_completed_cb(zero_copy_completed_cb cb, std::any param) {
+  _zero_copy_cb = cb;
+  _param_zero_copy_cb = param;
+}
+
+std::optional<proto::ip::full_address> const &stream::get_self_address() const {
+  auto const *set = (net::send::settings const *) get_settings();
+  if (set->_self_addr)
+    return set->_self_addr;
+  if (!_self_address && -1 != get_fd())
+    _self_address = get_address_from_file_descr(set->_peer_addr.get_address().get_version(), get_fd());
+  return _self_address;
 }
 
 bool stream::is_active() const {
@@ -105,25 +294,141 @@ bool stream::is_active() const {
 }
 
 void stream::receive_data() {
-  if (_received_data_cb)
+  if (_zero_copy_pending) {
+    // completions are reported as error queue event. check that we really have data to read
+    read_zero_copy_completions();
+    // data received by reactor is already taken from socket (socket is empty), event is always about data
+    std::byte peek;
+    if (!is_received_by_reactor() && -1 == ::recv(get_fd(), &peek, sizeof(peek), MSG_PEEK | MSG_DONTWAIT)
+        && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      errno = 0;
+      return;
+    }
+  }
+  if (auto *handler = get_handler(); handler)
+    handler->on_data(this);
+  else if (_received_data_cb)
     _received_data_cb(this, _param_received_data_cb);
 }
 
+void stream::receive_view() {
+  // buffer of reactor (every reactor is a thread). it is used by all streams of reactor, hence it is hot in cache
+  static thread_local std::vector<std::byte> reactor_buffer;
+  auto const *set = (net::send::settings const *) get_settings();
+  size_t const buffer_size = std::max<size_t>(set->_receive_buffer_size, 1);
+
+  bool destroyed = false;
+  _destroyed = &destroyed;
+  for (size_t i = 0; i < receive_view_budget && is_active(); ++i) {
+    // not consumed data is placed before new data, hence callback gets one contiguous block
+    size_t const pending = _unconsumed.size();
+    if (reactor_buffer.size() < pending + buffer_size)
+      reactor_buffer.resize(pending + buffer_size);
+    _unconsumed.copy(reactor_buffer.data(), pending);
+
+    ssize_t const rec = receive(reactor_buffer.data() + pending, buffer_size);
+    // state callback can destroy stream on error
+    if (destroyed)
+      return;
+    if (rec <= 0)
+      break;
+
+    size_t const size = pending + (size_t) rec;
+    size_t const consumed = std::min(_received_view_cb(this, reactor_buffer.data(), size, _param_received_view_cb), size);
+    if (destroyed)
+      return;
+    if (consumed <= pending) {
+      _unconsumed.erase(consumed);
+      _unconsumed.append(reactor_buffer.data() + pending, (size_t) rec);
+    } else {
+      _unconsumed.clear();
+      _unconsumed.append(reactor_buffer.data() + consumed, size - consumed);
+    }
+    // datagram is passed only once
+    if (_message_oriented)
+      _unconsumed.clear();
+    // peer can send data which callback never consumes (for instance message without end). reactor buffer grows too
+    if (set->_max_unconsumed_size && _unconsumed.size() > set->_max_unconsumed_size) {
+      set_detailed_error("not consumed received data exceeds limit");
+      if (!destroyed)
+        _destroyed = nullptr;
+      return;
+    }
+
+    // buffer isn't filled, hence receive queue of stream socket is empty
+    if (!_message_oriented && (size_t) rec < buffer_size)
+      break;
+  }
+  _destroyed = nullptr;
+}
+
+void stream::read_zero_copy_completions() {
+  while (_zero_copy_pending) {
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (-1 == ::recvmsg(get_fd(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT)) {
+      if (EINTR == errno) {
+        errno = 0;
+        continue;
+      }
+      // EAGAIN - error queue is empty
+      errno = 0;
+      return;
+    }
+
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+            || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+        continue;
+      auto const *err = (sock_extended_err const *) CMSG_DATA(cmsg);
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+      // range of completed sends [ee_info, ee_data]
+      uint32_t const completed = err->ee_data - err->ee_info + 1;
+      _zero_copy_pending = completed < _zero_copy_pending ? _zero_copy_pending - completed : 0;
+      if (_zero_copy_cb)
+        _zero_copy_cb(this, err->ee_info, err->ee_data, _param_zero_copy_cb);
+    }
+  }
+}
+
 void stream::send_buffered_data() {
-  if (_send_buffer.is_empty()) {
+  if (is_send_queue_empty()) {
     disable_send_cb();
+    // stream was idle for max delay. send tail of corked socket
+    if (_socket_corked)
+      _socket_corked = !cork_socket(false);
     return;
   }
 
   // check stream state
   switch (get_state()) {
   case state::e_established: {
-    auto data = _send_buffer.get_data();
-    auto sent = send_data(data.first, data.second);
-    if (sent > 0)
-      _send_buffer.erase(sent);
-    else if (sent < 0)
-      _send_buffer.clear();
+    if (!_files.empty()) {
+      send_buffered_files();
+      break;
+    }
+    if (_message_oriented) {
+      send_buffered_messages();
+      break;
+    }
+    if (_cork) {
+      send_buffered_segments();
+      break;
+    }
+    // buffer is segmented, hence send segment by segment while socket accepts whole segment
+    while (!_send_buffer.is_empty()) {
+      size_t size{0};
+      auto sent = send_buffer_head(_send_buffer.size(), size);
+      if (sent > 0)
+        _send_buffer.erase(sent);
+      else if (sent < 0)
+        _send_buffer.clear();
+      if (sent < 0 || (size_t) sent != size)
+        break;
+    }
     break;
   }
   case state::e_wait: {
@@ -132,15 +437,134 @@ void stream::send_buffered_data() {
   case state::e_failed:
     [[fallthrough]];
   case state::e_closed: {
-    _send_buffer.clear();
+    clear_send_buffer();
     return;
   }
   default:
     break;
   }
 
-  if (_send_buffer.is_empty())
+  if (is_send_queue_empty()) {
     disable_send_cb();
+    // tail of corked socket is sent if stream doesn't send anything during max delay
+    if (_socket_corked)
+      _write->defer(get_fd(), _cork_max_delay);
+  } else if (_cork) {
+    // corked stream is flushed by reactor. rest is sent on write event
+    enable_send_cb();
+  }
+  // last action. callback can send data or destroy stream
+  check_send_queue_drained();
+}
+
+void stream::check_send_queue_drained() {
+  if (!_send_queue_full || get_send_queue_size() > _low_watermark)
+    return;
+  _send_queue_full = false;
+  if (_send_queue_drained_cb)
+    _send_queue_drained_cb(this, _param_send_queue_drained_cb);
+}
+
+void stream::send_buffered_files() {
+  while (!_files.empty()) {
+    auto &file = _files.front();
+    if (!send_buffered_bytes(file._preceding))
+      return;
+    while (file._size) {
+      ssize_t const sent = send_file_data(file._fd, file._offset, file._size);
+      if (sent < 0) {
+        clear_send_buffer();
+        return;
+      }
+      // would block. wait for next write event
+      if (0 == sent)
+        return;
+      file._offset += sent;
+      file._size -= (size_t) sent;
+      _queued_file_size -= (size_t) sent;
+    }
+    ::close(file._fd);
+    _files.pop_front();
+  }
+  // data buffered after last file
+  size_t rest = _send_buffer.size();
+  send_buffered_bytes(rest);
+}
+
+bool stream::send_buffered_bytes(size_t &size) {
+  while (size) {
+    size_t to_send{0};
+    ssize_t const sent = send_buffer_head(size, to_send);
+    if (sent < 0) {
+      clear_send_buffer();
+      return false;
+    }
+    _send_buffer.erase((size_t) sent);
+    size -= (size_t) sent;
+    if ((size_t) sent != to_send)
+      return false;
+  }
+  return true;
+}
+
+ssize_t stream::send_buffer_head(size_t limit, size_t &size) {
+  auto data = _send_buffer.get_data();
+  if (data.second >= limit || data.second >= get_retry_write_size()) {
+    size = std::min(limit, data.second);
+    return send_data(data.first, size);
+  }
+  // unfinished write is retried with the same amount of data
+  iovec segments[cork_max_segments];
+  size_t count = _send_buffer.get_segments(segments, cork_max_segments);
+  size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (size + segments[i].iov_len >= limit) {
+      segments[i].iov_len = limit - size;
+      count = i + 1;
+    }
+    size += segments[i].iov_len;
+  }
+  return send_data_v(segments, count);
+}
+
+void stream::send_buffered_segments() {
+  if (_cork_max_delay.count() && !_socket_corked)
+    _socket_corked = cork_socket(true);
+  while (!_send_buffer.is_empty()) {
+    iovec segments[cork_max_segments];
+    size_t const count = _send_buffer.get_segments(segments, cork_max_segments);
+    size_t const size = strm::get_iovec_size(segments, count);
+    auto sent = send_data_v(segments, count);
+    if (sent > 0)
+      _send_buffer.erase(sent);
+    else if (sent < 0)
+      _send_buffer.clear();
+    if (sent < 0 || (size_t) sent != size)
+      break;
+  }
+}
+
+void stream::send_buffered_messages() {
+  while (!_buffered_messages.empty()) {
+    size_t const message_size = _buffered_messages.front();
+    auto data = _send_buffer.get_data();
+    if (data.second < message_size) {
+      // message must be sent with one call
+      _message.resize(message_size);
+      _send_buffer.copy(_message.data(), message_size);
+      data.first = _message.data();
+    }
+    auto sent = send_data(data.first, message_size);
+    if (sent < 0) {
+      clear_send_buffer();
+      return;
+    }
+    // would block. wait for next write event
+    if (0 == sent && message_size)
+      return;
+    _send_buffer.erase(message_size);
+    _buffered_messages.pop_front();
+  }
 }
 
 void stream::disable_send_cb() {
@@ -148,12 +572,13 @@ void stream::disable_send_cb() {
 }
 
 void stream::enable_send_cb() {
-  if (!_send_buffer.is_empty())
+  if (!is_send_queue_empty())
     _write->start(get_fd());
 }
 
 void stream::cleanup() {
   stop_events();
+  clear_send_buffer();
   net::stream::cleanup();
 }
 
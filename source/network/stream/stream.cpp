@@ -24,13 +24,19 @@ void stream::set_state_changed_cb(strm::state_changed_cb cb, std::any user_data)
   _param_state_changed_cb = user_data;
 }
 
+void stream::set_handler(strm::stream_handler *handler, bool /*writable_events*/) {
+  _handler = handler;
+}
+
 void stream::set_connection_state(state new_state) {
   if (_state == new_state)
     return;
   _state = new_state;
   if (state::e_failed == _state)
     cleanup();
-  if (_state_changed_cb)
+  if (_handler)
+    _handler->on_state(this);
+  else if (_state_changed_cb)
     _state_changed_cb(this, _param_state_changed_cb);
 }
 
@@ -59,9 +65,9 @@ bool stream::create_socket(proto::ip::address::version version, socket_type s_ty
   return true;
 }
 
-bool stream::set_socket_options() {
+bool stream::set_socket_options(bool non_blocking_set) {
   settings *set = (settings *) get_settings();
-  if (set->_non_blocking_socket && !set_non_blocking_mode(_file_descr, get_error_description()))
+  if (set->_non_blocking_socket && !non_blocking_set && !set_non_blocking_mode(_file_descr, get_error_description()))
     return false;
 
   if (set->_buffer_size && !set_socket_buffer_size(_file_descr, *set->_buffer_size, get_error_description()))
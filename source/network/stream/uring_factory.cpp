@@ -0,0 +1,679 @@
+#include <network/platforms/system.h>
+#include <network/stream/factory.h>
+#include <network/stream/listen/stream.h>
+#include <network/stream/registry.h>
+#include <network/stream/send/stream.h>
+#include <network/stream/uring_factory.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <poll.h>
+#include <unistd.h>
+#include <utility>
+
+namespace bro::net::uring {
+
+/*! \brief group id of provided buffers for multishot recv
+ */
+static constexpr uint16_t buffer_group = 0;
+
+/*! \brief max number of provided buffers in ring
+ */
+static constexpr uint16_t max_buffers_count = 1 << 15;
+
+/*! \brief io_uring_setup system call
+ */
+static int uring_setup(unsigned entries, io_uring_params *params) {
+  return (int) ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+/*! \brief io_uring_enter system call
+ */
+static int uring_enter(int ring_fd, unsigned to_submit, unsigned flags) {
+  return (int) ::syscall(__NR_io_uring_enter, ring_fd, to_submit, 0, flags, nullptr, 0);
+}
+
+/*! \brief io_uring_register system call
+ */
+static int uring_register(int ring_fd, unsigned opcode, void *arg, unsigned nr_args) {
+  return (int) ::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+/*! \brief map memory shared with kernel (anonymous if ring_fd is -1)
+ *  \return pointer on mapped memory or nullptr
+ */
+static void *map_memory(size_t size, int ring_fd, off_t offset) {
+  void *res = ::mmap(nullptr,
+                     size,
+                     PROT_READ | PROT_WRITE,
+                     -1 == ring_fd ? MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE : MAP_SHARED | MAP_POPULATE,
+                     ring_fd,
+                     offset);
+  return MAP_FAILED == res ? nullptr : res;
+}
+
+/**
+ * \brief events source based on io_uring requests
+ *
+ * Poll kinds are readiness based (stream makes system calls itself). Accept and recv kinds are
+ * completion based - multishot requests fill queue of accepted connections/received buffers.
+ * Callbacks are called from \ref factory::proceed while io has events (level triggered like libev).
+ */
+class uring_io : public net::io {
+public:
+  /*!
+   * @brief type of request
+   */
+  enum class kind : uint8_t {
+    e_poll_read,  ///< wait socket is readable
+    e_poll_write, ///< wait socket is writable
+    e_accept,     ///< multishot accept
+    e_recv        ///< multishot recv into provided buffers
+  };
+
+  /*! \brief constructor
+   *  \param [in] manager owning factory
+   *  \param [in] type type of request
+   */
+  uring_io(factory &manager, kind type) noexcept
+    : _factory(manager)
+    , _kind(type) {}
+
+  ~uring_io() override {
+    stop();
+    // io is destroyed by own callback
+    if (this == _factory._dispatched)
+      _factory._destroyed = true;
+  }
+
+  uring_io(uring_io const &) = delete;
+  uring_io &operator=(uring_io const &) = delete;
+
+  void start(int fd, callback_t cb) override {
+    _cb = std::move(cb);
+    start(fd);
+  }
+
+  void start(int fd) override {
+    if (_active && fd == _fd) {
+      resume(fd);
+      return;
+    }
+    stop();
+    _fd = fd;
+    _active = true;
+    arm();
+  }
+
+  void stop() override {
+    if (!_active)
+      return;
+    _active = false;
+    _paused = false;
+    _fired = false;
+    if (_request) {
+      _factory.cancel(_request);
+      _request = nullptr;
+    }
+    for (auto const &rec : _received)
+      _factory.recycle_buffer(rec._id);
+    _received.clear();
+    for (int fd : _accepted)
+      ::close(fd);
+    _accepted.clear();
+    _error = 0;
+    _eof = false;
+    _factory.forget(this);
+  }
+
+  void pause() override {
+    if (!_active || _paused)
+      return;
+    _paused = true;
+    // multishot request is finished, but its completions still fill io (received data isn't lost)
+    if (_request && is_completion())
+      _factory.cancel(_request, false);
+  }
+
+  void resume(int fd) override {
+    if (!_active || fd != _fd) {
+      start(fd);
+      return;
+    }
+    if (!_paused)
+      return;
+    _paused = false;
+    if (!_request && !_eof && !_error)
+      arm();
+    if (has_events())
+      _factory.set_ready(this);
+  }
+
+  void set_callback(callback_t cb) override { _cb = std::move(cb); }
+
+  bool is_active() const override { return _active; }
+
+  bool is_completion() const noexcept override { return kind::e_accept == _kind || kind::e_recv == _kind; }
+
+  /*! \brief check io waits new request (it is started, not paused and hasn't in flight request)
+   */
+  bool needs_request() const noexcept { return _active && !_paused && !_request; }
+
+  ssize_t read(std::byte *data, size_t data_size) override {
+    iovec vec{data, data_size};
+    return readv(&vec, 1);
+  }
+
+  ssize_t readv(iovec *vec, size_t count) override {
+    if (_received.empty()) {
+      if (!_eof && !_error)
+        return 0;
+      // connection is closed by peer (errno is 0) or failed
+      errno = _error;
+      return -1;
+    }
+
+    size_t copied{0};
+    for (size_t i = 0; i < count && !_received.empty(); ++i) {
+      size_t filled{0};
+      while (filled < vec[i].iov_len && !_received.empty()) {
+        auto &front = _received.front();
+        size_t const to_copy = std::min<size_t>(vec[i].iov_len - filled, front._size - front._offset);
+        std::memcpy(static_cast<std::byte *>(vec[i].iov_base) + filled,
+                    _factory.get_buffer(front._id) + front._offset,
+                    to_copy);
+        filled += to_copy;
+        front._offset += (uint32_t) to_copy;
+        if (front._offset == front._size) {
+          uint16_t const id = front._id;
+          _received.pop_front();
+          _factory.recycle_buffer(id);
+        }
+      }
+      copied += filled;
+    }
+    return (ssize_t) copied;
+  }
+
+  int accept() override {
+    if (!_accepted.empty()) {
+      int const fd = _accepted.front();
+      _accepted.pop_front();
+      return fd;
+    }
+    errno = std::exchange(_error, 0);
+    return -1;
+  }
+
+  /*! \brief submit request for current kind
+   */
+  void arm() {
+    io_uring_sqe *sqe = _factory.get_sqe();
+    if (!sqe) {
+      // submission queue is full. retry in next proceed
+      _factory._unarmed.push_back(this);
+      return;
+    }
+    sqe->fd = _fd;
+    switch (_kind) {
+    case kind::e_poll_read:
+      sqe->opcode = IORING_OP_POLL_ADD;
+      sqe->poll32_events = POLLIN;
+      break;
+    case kind::e_poll_write:
+      sqe->opcode = IORING_OP_POLL_ADD;
+      sqe->poll32_events = POLLOUT;
+      break;
+    case kind::e_accept:
+      sqe->opcode = IORING_OP_ACCEPT;
+      sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+      sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+      break;
+    case kind::e_recv:
+      sqe->opcode = IORING_OP_RECV;
+      sqe->ioprio = IORING_RECV_MULTISHOT;
+      sqe->flags = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = buffer_group;
+      break;
+    }
+    _request = _factory.create_request(this, kind::e_accept == _kind);
+    _recycled_on_arm = _factory._recycled;
+    sqe->user_data = reinterpret_cast<uint64_t>(_request);
+  }
+
+  /*! \brief handle completion of own request
+   *  \param [in] res result of request
+   *  \param [in] flags completion flags
+   *  \param [in] last request is finished (no more completions)
+   */
+  void complete(int32_t res, uint32_t flags, bool last) {
+    if (last)
+      _request = nullptr;
+    switch (_kind) {
+    case kind::e_poll_read:
+      [[fallthrough]];
+    case kind::e_poll_write:
+      // socket errors are reported by poll events, stream finds them out by system call
+      _fired = true;
+      break;
+    case kind::e_accept:
+      if (res >= 0)
+        _accepted.push_back(res);
+      else if (!fall_back_to_poll(res, last) && -ECANCELED != res)
+        _error = -res;
+      if (last && _active && !_paused && kind::e_accept == _kind)
+        arm();
+      break;
+    case kind::e_recv:
+      if (flags & IORING_CQE_F_BUFFER) {
+        uint16_t const id = uint16_t(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (res > 0)
+          _received.push_back({id, 0, (uint32_t) res});
+        else
+          _factory.recycle_buffer(id);
+      }
+      if (0 == res) {
+        _eof = true;
+      } else if (-ENOBUFS == res) {
+        // all provided buffers are in use. restart when somebody returns buffer
+        // (immediately if buffer was returned after request was armed, kernel could miss it)
+        if (last && _active && !_paused && _recycled_on_arm == _factory._recycled)
+          _factory._starving.push_back(this);
+        else if (last && _active && !_paused)
+          arm();
+      } else if (res < 0 && !fall_back_to_poll(res, last) && -ECANCELED != res) {
+        _error = -res;
+      }
+      if (last && _active && !_paused && kind::e_recv == _kind && !_eof && !_error && -ENOBUFS != res)
+        arm();
+      break;
+    }
+    if (_active && !_paused && has_events())
+      _factory.set_ready(this);
+  }
+
+  /*! \brief call callback if io has events
+   *
+   * \note callback can destroy io
+   */
+  void dispatch() {
+    if (!_active || _paused || !has_events())
+      return;
+    _fired = false;
+    auto &manager = _factory;
+    manager._destroyed = false;
+    manager._dispatched = this;
+    _cb();
+    if (manager._destroyed)
+      return;
+    manager._dispatched = nullptr;
+    if (!_active)
+      return;
+    if (is_poll() && !_request)
+      arm();
+    else if (has_events())
+      _factory.set_ready(this);
+  }
+
+  bool _in_ready{false}; ///< io is in ready list
+
+private:
+  /*!
+   * @brief data received into provided buffer
+   */
+  struct received {
+    uint16_t _id;     ///< buffer id
+    uint32_t _offset; ///< offset of first unread byte
+    uint32_t _size;   ///< received bytes
+  };
+
+  /*! \brief check io is readiness based
+   */
+  bool is_poll() const noexcept { return kind::e_poll_read == _kind || kind::e_poll_write == _kind; }
+
+  /*! \brief check io has something for callback
+   */
+  bool has_events() const noexcept {
+    return _fired || !_received.empty() || !_accepted.empty() || _eof || _error;
+  }
+
+  /*! \brief switch to poll request if kernel doesn't support multishot request
+   *  \return true if switched
+   */
+  bool fall_back_to_poll(int32_t res, bool last) {
+    if (-EINVAL != res || !last || !_received.empty() || !_accepted.empty())
+      return false;
+    _kind = kind::e_poll_read;
+    if (_active && !_paused)
+      arm();
+    return true;
+  }
+
+  factory &_factory;                   ///< owning factory
+  kind _kind;                          ///< type of request
+  int _fd{-1};                         ///< file descriptor
+  callback_t _cb;                      ///< event callback
+  factory::request *_request{nullptr}; ///< in flight request
+  uint64_t _recycled_on_arm{0};        ///< number of returned provided buffers when request was armed
+  std::deque<received> _received;      ///< received data (recv kind)
+  std::deque<int> _accepted;           ///< accepted connections (accept kind)
+  int _error{0};                       ///< error of request (errno value)
+  bool _eof{false};                    ///< connection is closed by peer (recv kind)
+  bool _fired{false};                  ///< poll request is completed (poll kinds)
+  bool _active{false};                 ///< io is started
+  bool _paused{false};                 ///< io doesn't take new data and doesn't call callback (\ref pause)
+};
+
+factory::factory()
+  : factory(config{}) {}
+
+factory::factory(config const &conf)
+  : _chunks(conf._chunks) {
+  if (!init(conf))
+    return;
+  if (!init_buffers(conf))
+    append_error(_err, "provided buffers aren't supported, tcp streams will be polled");
+}
+
+factory::~factory() {
+  for (auto *req : _requests)
+    delete req;
+  if (-1 != _ring_fd)
+    ::close(_ring_fd);
+  if (_buffers)
+    ::munmap(_buffers, _buffers_size);
+  if (_buf_ring)
+    ::munmap(_buf_ring, _buf_ring_size);
+  if (_sqes)
+    ::munmap(_sqes, _sqes_size);
+  if (_cq_ring && _cq_ring != _sq_ring)
+    ::munmap(_cq_ring, _cq_ring_size);
+  if (_sq_ring)
+    ::munmap(_sq_ring, _sq_ring_size);
+}
+
+bool factory::is_supported() noexcept {
+  io_uring_params params{};
+  int const fd = uring_setup(2, &params);
+  if (-1 == fd) {
+    errno = 0;
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+
+bool factory::init(config const &conf) {
+  io_uring_params params{};
+  // don't stop submission on the first failed request
+  // multishot requests produce several completions per submission, hence completion queue is bigger
+  params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_CLAMP | IORING_SETUP_CQSIZE;
+  params.cq_entries = conf._entries * 4;
+  int fd = uring_setup(conf._entries, &params);
+  if (-1 == fd && EINVAL == errno) {
+    errno = 0;
+    params = {};
+    params.flags = IORING_SETUP_CLAMP;
+    fd = uring_setup(conf._entries, &params);
+  }
+  if (-1 == fd) {
+    append_error(_err, "couldn't setup io_uring");
+    return false;
+  }
+
+  _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool const single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap)
+    _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+  _sq_ring = map_memory(_sq_ring_size, fd, IORING_OFF_SQ_RING);
+  _cq_ring = single_mmap ? _sq_ring : map_memory(_cq_ring_size, fd, IORING_OFF_CQ_RING);
+  _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  _sqes = static_cast<io_uring_sqe *>(map_memory(_sqes_size, fd, IORING_OFF_SQES));
+  if (!_sq_ring || !_cq_ring || !_sqes) {
+    append_error(_err, "couldn't map io_uring rings");
+    ::close(fd);
+    return false;
+  }
+
+  auto *sq = static_cast<std::byte *>(_sq_ring);
+  _sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  _sq_flags = reinterpret_cast<unsigned *>(sq + params.sq_off.flags);
+  _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  _sq_entries = params.sq_entries;
+  _sq_local_tail = *_sq_tail;
+  // submission entries are always used in ring order
+  auto *sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  for (unsigned i = 0; i < _sq_entries; ++i)
+    sq_array[i] = i;
+
+  auto *cq = static_cast<std::byte *>(_cq_ring);
+  _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  _ring_fd = fd;
+  return true;
+}
+
+bool factory::init_buffers(config const &conf) {
+  uint32_t count = std::min<uint32_t>(std::max<uint16_t>(conf._buffers_count, 1), max_buffers_count);
+  // ring size must be power of 2
+  while (count & (count - 1))
+    count &= count - 1;
+  _buffer_size = std::max<uint32_t>(conf._buffer_size, 1);
+  _buf_ring_size = count * sizeof(io_uring_buf);
+  _buffers_size = size_t(count) * _buffer_size;
+  _buf_ring = static_cast<io_uring_buf *>(map_memory(_buf_ring_size, -1, 0));
+  _buffers = static_cast<std::byte *>(map_memory(_buffers_size, -1, 0));
+  io_uring_buf_reg reg{};
+  if (_buf_ring && _buffers) {
+    reg.ring_addr = reinterpret_cast<uint64_t>(_buf_ring);
+    reg.ring_entries = count;
+    reg.bgid = buffer_group;
+  }
+  if (!_buf_ring || !_buffers || 0 != uring_register(_ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1)) {
+    if (_buffers)
+      ::munmap(_buffers, _buffers_size);
+    if (_buf_ring)
+      ::munmap(_buf_ring, _buf_ring_size);
+    _buffers = nullptr;
+    _buf_ring = nullptr;
+    return false;
+  }
+
+  _buf_mask = uint16_t(count - 1);
+  for (uint32_t id = 0; id < count; ++id)
+    provide_buffer(uint16_t(id));
+  return true;
+}
+
+strm::stream_ptr factory::create_stream(strm::settings *stream_set) {
+  return net::create_stream(stream_set);
+}
+
+void factory::bind(strm::stream_ptr &stream) {
+  switch (get_stream_kind(stream.get())) {
+  case stream_kind::e_send: {
+    auto *st = static_cast<bro::net::send::stream *>(stream.get());
+    st->set_chunk_pool(&_chunks);
+    bool const recv = _buf_ring && st->is_receive_by_reactor_supported();
+    st->assign_events(std::make_unique<uring_io>(*this, recv ? uring_io::kind::e_recv : uring_io::kind::e_poll_read),
+                      std::make_unique<uring_io>(*this, uring_io::kind::e_poll_write));
+    break;
+  }
+  case stream_kind::e_listen: {
+    auto *st = static_cast<bro::net::listen::stream *>(stream.get());
+    bool const accept = st->is_accept_by_reactor_supported();
+    st->assign_event(
+      std::make_unique<uring_io>(*this, accept ? uring_io::kind::e_accept : uring_io::kind::e_poll_read));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+io_uring_sqe *factory::get_sqe() {
+  if (!is_active())
+    return nullptr;
+  if (_sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+    submit(true);
+    if (_sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries)
+      return nullptr;
+  }
+  io_uring_sqe *sqe = &_sqes[_sq_local_tail & _sq_mask];
+  std::memset(sqe, 0, sizeof(*sqe));
+  ++_sq_local_tail;
+  return sqe;
+}
+
+void factory::submit(bool get_events) {
+  __atomic_store_n(_sq_tail, _sq_local_tail, __ATOMIC_RELEASE);
+  unsigned const to_submit = _sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+  if (!to_submit && !get_events)
+    return;
+  while (-1 == uring_enter(_ring_fd, to_submit, get_events ? IORING_ENTER_GETEVENTS : 0)) {
+    if (EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+    // EAGAIN/EBUSY - kernel is out of resources or completion queue is overflown. retry in next proceed
+    errno = 0;
+    break;
+  }
+}
+
+factory::request *factory::create_request(uring_io *owner, bool accept) {
+  auto *req = new request{owner, accept};
+  _requests.insert(req);
+  return req;
+}
+
+void factory::cancel(request *req, bool detach) {
+  if (detach)
+    req->_owner = nullptr;
+  io_uring_sqe *sqe = get_sqe();
+  if (!sqe) {
+    // submission queue is full. retry in next proceed
+    _uncanceled.push_back(req);
+    return;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(req);
+  // zero user data - completion of cancel is ignored
+}
+
+void factory::complete(uint64_t user_data, int32_t res, uint32_t flags) {
+  auto *req = reinterpret_cast<request *>(user_data);
+  if (!req)
+    return;
+  bool const last = !(flags & IORING_CQE_F_MORE);
+  if (req->_owner) {
+    req->_owner->complete(res, flags, last);
+  } else if (flags & IORING_CQE_F_BUFFER) {
+    recycle_buffer(uint16_t(flags >> IORING_CQE_BUFFER_SHIFT));
+  } else if (req->_accept && res >= 0) {
+    // connection accepted after cancel
+    ::close(res);
+  }
+  if (last) {
+    _requests.erase(req);
+    delete req;
+  }
+}
+
+void factory::provide_buffer(uint16_t id) {
+  io_uring_buf &buf = _buf_ring[_buf_tail & _buf_mask];
+  buf.addr = reinterpret_cast<uint64_t>(get_buffer(id));
+  buf.len = _buffer_size;
+  buf.bid = id;
+  ++_buf_tail;
+  // ring tail is placed instead of resv field of the first entry
+  __atomic_store_n(&_buf_ring[0].resv, _buf_tail, __ATOMIC_RELEASE);
+}
+
+void factory::recycle_buffer(uint16_t id) {
+  provide_buffer(id);
+  ++_recycled;
+  // one returned buffer - one restarted request, otherwise all starving requests fail again
+  while (!_starving.empty()) {
+    uring_io *io = _starving.front();
+    _starving.pop_front();
+    if (io->needs_request()) {
+      io->arm();
+      break;
+    }
+  }
+}
+
+void factory::set_ready(uring_io *io) {
+  if (io->_in_ready)
+    return;
+  io->_in_ready = true;
+  _ready.push_back(io);
+}
+
+void factory::forget(uring_io *io) noexcept {
+  if (io->_in_ready) {
+    io->_in_ready = false;
+    std::replace(_ready.begin(), _ready.end(), io, (uring_io *) nullptr);
+  }
+  std::replace(_dispatching.begin(), _dispatching.end(), io, (uring_io *) nullptr);
+  _starving.erase(std::remove(_starving.begin(), _starving.end(), io), _starving.end());
+  _unarmed.erase(std::remove(_unarmed.begin(), _unarmed.end(), io), _unarmed.end());
+}
+
+void factory::retry_submissions() {
+  if (!_uncanceled.empty()) {
+    std::vector<request *> uncanceled;
+    uncanceled.swap(_uncanceled);
+    for (auto *req : uncanceled) {
+      // request can be finished while cancel was waiting
+      if (_requests.count(req))
+        cancel(req, false);
+    }
+  }
+  if (!_unarmed.empty()) {
+    std::vector<uring_io *> unarmed;
+    unarmed.swap(_unarmed);
+    for (auto *io : unarmed) {
+      if (io->needs_request())
+        io->arm();
+    }
+  }
+}
+
+void factory::proceed() {
+  if (!is_active())
+    return;
+  retry_submissions();
+  submit(__atomic_load_n(_sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW);
+
+  unsigned head = *_cq_head;
+  while (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+    io_uring_cqe const &cqe = _cqes[head & _cq_mask];
+    uint64_t const user_data = cqe.user_data;
+    int32_t const res = cqe.res;
+    uint32_t const flags = cqe.flags;
+    __atomic_store_n(_cq_head, ++head, __ATOMIC_RELEASE);
+    complete(user_data, res, flags);
+  }
+
+  _dispatching.swap(_ready);
+  for (size_t i = 0; i < _dispatching.size(); ++i) {
+    uring_io *io = _dispatching[i];
+    if (!io)
+      continue;
+    io->_in_ready = false;
+    io->dispatch();
+  }
+  _dispatching.clear();
+}
+
+} // namespace bro::net::uring
@@ -7,6 +7,7 @@ namespace bro::net::tcp::listen {
 bool stream::create_listen_socket() {
   if (create_socket(_settings._listen_address.get_address().get_version(), socket_type::e_tcp)
       && reuse_address(get_fd(), get_error_description())
+      && (!_settings._reuse_port || reuse_port(get_fd(), get_error_description()))
       && bind_on_address(_settings._listen_address, get_fd(), get_error_description())
       && start_listen(get_fd(), _settings._listen_backlog, get_error_description()))
     return true;
@@ -14,8 +15,23 @@ bool stream::create_listen_socket() {
   return false;
 }
 
-std::unique_ptr<net::stream> stream::generate_send_stream() {
-  return std::make_unique<tcp::send::stream>();
+stream::send_stream_ptr stream::generate_send_stream() {
+  return make_send_stream<tcp::send::stream>();
+}
+
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) {
+  if (!net::listen::stream::fill_send_stream(result, sck))
+    return false;
+  if (!_settings._not_sent_low_watermark)
+    return true;
+
+  auto *s = (tcp::send::stream *) sck.get();
+  s->_settings._not_sent_low_watermark = _settings._not_sent_low_watermark;
+  if (!set_not_sent_low_watermark(s->get_fd(), *_settings._not_sent_low_watermark, s->get_error_description())) {
+    s->set_connection_state(state::e_failed);
+    return false;
+  }
+  return true;
 }
 
 bool stream::init(settings *listen_params) {
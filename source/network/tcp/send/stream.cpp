@@ -1,5 +1,8 @@
 #include <network/platforms/system.h>
 #include <network/tcp/send/stream.h>
+#include <limits.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
 
 namespace bro::net::tcp::send {
 
@@ -20,24 +23,43 @@ bool stream::init(settings *send_params) {
 }
 
 ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
+  // data is already received by reactor. socket must not be read directly (it breaks data order)
+  if (is_received_by_reactor())
+    return account_received(read_received(buffer, buffer_size), buffer_size);
+
   ssize_t rec{0};
   while (true) {
     rec = ::recv(get_fd(), buffer, buffer_size, MSG_NOSIGNAL);
     if (rec > 0) {
       ++_statistic._success_recv_data;
+      // buffer isn't filled, hence receive queue is empty
+      if ((size_t) rec < buffer_size)
+        receive_would_block();
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == rec && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_recv_data;
       continue;
     }
 
+    if (-1 == rec && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // no data yet. would block
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      rec = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (buffer_size == 0 && rec == 0)
       break;
 
+    // connection is closed by peer. stream is half closed and can still send
+    if (rec == 0 && peer_closed())
+      break;
+
     set_detailed_error("recv return error");
     ++_statistic._failed_recv_data;
     rec = -1;
@@ -46,6 +68,68 @@ ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
   return rec;
 }
 
+ssize_t stream::receivev(iovec *vec, size_t count) {
+  // data is already received by reactor. socket must not be read directly (it breaks data order)
+  if (is_received_by_reactor())
+    return account_received(read_received_v(vec, count), strm::get_iovec_size(vec, count));
+
+  ssize_t rec{0};
+  while (true) {
+    rec = ::readv(get_fd(), vec, count);
+    if (rec > 0) {
+      ++_statistic._success_recv_data;
+      // buffers aren't filled, hence receive queue is empty
+      if ((size_t) rec < strm::get_iovec_size(vec, count))
+        receive_would_block();
+      break;
+    }
+
+    if (-1 == rec && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == rec && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // no data yet. would block
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      rec = 0;
+      break;
+    }
+
+    // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
+    if (rec == 0 && strm::get_iovec_size(vec, count) == 0)
+      break;
+
+    // connection is closed by peer. stream is half closed and can still send
+    if (rec == 0 && peer_closed())
+      break;
+
+    set_detailed_error("readv return error");
+    ++_statistic._failed_recv_data;
+    rec = -1;
+    break;
+  }
+  return rec;
+}
+
+ssize_t stream::account_received(ssize_t rec, size_t buffer_size) {
+  if (rec > 0) {
+    ++_statistic._success_recv_data;
+  } else if (0 == rec) {
+    if (buffer_size)
+      ++_statistic._retry_recv_data;
+  } else if (0 == errno && peer_closed()) {
+    // connection is closed by peer (errno isn't set). stream is half closed and can still send
+    rec = 0;
+  } else {
+    set_detailed_error("recv return error");
+    ++_statistic._failed_recv_data;
+  }
+  return rec;
+}
+
 bool stream::connection_established() {
   if (!net::send::stream::connection_established()) {
     return false;
@@ -62,21 +146,32 @@ bool stream::connect() {
 }
 
 ssize_t stream::send_data(std::byte const *data, size_t data_size) {
+  int const zero_copy_flag = get_zero_copy_flag(data_size);
   // start to send
   ssize_t sent{0};
   while (true) {
-    sent = ::send(get_fd(), data, data_size, MSG_NOSIGNAL);
+    sent = ::send(get_fd(), data, data_size, MSG_NOSIGNAL | zero_copy_flag);
     if (sent > 0) {
+      if (zero_copy_flag)
+        zero_copy_sent();
       ++_statistic._success_send_data;
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == sent && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_send_data;
       continue;
     }
 
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (data_size == 0 && sent == 0)
       break;
@@ -89,6 +184,89 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
   return sent;
 }
 
+ssize_t stream::send_file_data(int file_fd, off_t offset, size_t size) {
+  ssize_t sent{0};
+  while (true) {
+    sent = ::sendfile(get_fd(), file_fd, &offset, size);
+    if (sent > 0) {
+      ++_statistic._success_send_data;
+      break;
+    }
+
+    if (-1 == sent && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent part of file is queued and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
+    if (size == 0 && sent == 0)
+      break;
+
+    set_detailed_error(sent ? "sendfile return error" : "file is shorter than requested size");
+    ++_statistic._failed_send_data;
+    sent = -1;
+    break;
+  }
+  return sent;
+}
+
+bool stream::cork_socket(bool enable) {
+  // without cork data is sent as usual, hence error isn't fatal for stream
+  std::string err;
+  return set_tcp_cork(get_fd(), enable, err);
+}
+
+ssize_t stream::send_data_v(iovec const *vec, size_t count) {
+  msghdr msg{};
+  msg.msg_iov = const_cast<iovec *>(vec);
+  // send no more than system limit. tail will be buffered as partial send
+  msg.msg_iovlen = count < IOV_MAX ? count : IOV_MAX;
+  int const zero_copy_flag = get_zero_copy_flag(strm::get_iovec_size(vec, count));
+  // start to send
+  ssize_t sent{0};
+  while (true) {
+    sent = ::sendmsg(get_fd(), &msg, MSG_NOSIGNAL | zero_copy_flag);
+    if (sent > 0) {
+      if (zero_copy_flag)
+        zero_copy_sent();
+      ++_statistic._success_send_data;
+      break;
+    }
+
+    if (-1 == sent && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
+    // 0 may also be returned if the requested number of bytes to send was 0
+    if (sent == 0 && strm::get_iovec_size(vec, count) == 0)
+      break;
+
+    set_detailed_error("sendmsg return error");
+    ++_statistic._failed_send_data;
+    sent = -1;
+    break;
+  }
+  return sent;
+}
+
 void stream::reset_statistic() {
   _statistic.reset();
 }
@@ -101,6 +279,16 @@ bool stream::create_socket(proto::ip::address::version version, socket_type s_ty
     set_connection_state(state::e_failed);
     return false;
   }
+  if (((net::send::settings const *) get_settings())->_zero_copy
+      && !enable_zero_copy(get_fd(), get_error_description())) {
+    set_connection_state(state::e_failed);
+    return false;
+  }
+  if (auto const &lowat = ((settings const *) get_settings())->_not_sent_low_watermark;
+      lowat && !set_not_sent_low_watermark(get_fd(), *lowat, get_error_description())) {
+    set_connection_state(state::e_failed);
+    return false;
+  }
   return true;
 }
 
@@ -21,15 +21,16 @@ stream::~stream() {
   stream::cleanup();
 }
 
-std::unique_ptr<net::stream> stream::generate_send_stream() {
-  return std::make_unique<bro::net::tcp::ssl::send::stream>();
+stream::send_stream_ptr stream::generate_send_stream() {
+  return make_send_stream<bro::net::tcp::ssl::send::stream>();
 }
 
-bool stream::fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) {
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) {
   if (!tcp::listen::stream::fill_send_stream(result, sck))
     return false;
 
   ssl::send::stream *s = (ssl::send::stream *) sck.get();
+  s->_settings._enable_ktls = _settings._enable_ktls;
   s->_ctx = SSL_new(_ctx);
   if (!s->_ctx) {
     s->set_detailed_error(net::ssl::fill_error("couldn't create ssl context"));
@@ -96,6 +97,10 @@ bool stream::init(settings *listen_params) {
   SSL_CTX_set_mode(_ctx, SSL_MODE_RELEASE_BUFFERS);
 #endif
 
+  /* After SSL_ERROR_WANT_WRITE write is retried from the send buffer (other address, maybe bigger size).
+   * Partial write returns after every written record, hence unsent tail always stays in the send buffer */
+  SSL_CTX_set_mode(_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
   ctx_option_t ctx_options = (SSL_OP_ALL & ~SSL_OP_DONT_INSERT_EMPTY_FRAGMENTS);
 
 #ifdef SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG
@@ -103,6 +108,12 @@ bool stream::init(settings *listen_params) {
   ctx_options &= ~SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG;
 #endif
 
+#ifdef SSL_OP_ENABLE_KTLS
+  // openssl switches accepted sockets into kernel tls after handshake (if kernel and cipher support it)
+  if (_settings._enable_ktls)
+    ctx_options |= SSL_OP_ENABLE_KTLS;
+#endif
+
 #ifdef SSL_OP_DONT_INSERT_EMPTY_FRAGMENTS
   /* unless the user explicitly asks to allow the protocol vulnerability we
      use the work-around */
@@ -140,6 +151,10 @@ bool stream::init(settings *listen_params) {
       return false;
     }
   }
+
+  /* sessions of clients are resumed only in the same context (peer certificate is verified) */
+  static unsigned char const session_id_context[] = "bro::net::tcp::ssl";
+  SSL_CTX_set_session_id_context(_ctx, session_id_context, sizeof(session_id_context) - 1);
   return true;
 }
 
@@ -1,7 +1,12 @@
 #include <network/common/ssl.h>
 #include <network/tcp/ssl/send/stream.h>
+#include <openssl/bio.h>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <climits>
+#include <cstring>
 
 namespace bro::net::tcp::ssl::send {
 
@@ -17,7 +22,7 @@ void stream::cleanup() {
   }
 
   if (_client_ctx) {
-    SSL_CTX_free(_client_ctx);
+    net::ssl::release_client_ctx(_client_ctx);
     _client_ctx = nullptr;
   }
   tcp::send::stream::cleanup();
@@ -50,35 +55,43 @@ bool stream::init(settings *send_params) {
   _settings = *send_params;
   ERR_clear_error();
 
-  _client_ctx = SSL_CTX_new(TLS_client_method());
-  if (!_client_ctx) {
-    set_detailed_error(net::ssl::fill_error("coulnd't create ssl client context"));
-    return false;
-  }
-
+  net::ssl::client_ctx_params params;
+  params._method = TLS_client_method();
   if (_settings._min_version)
-    SSL_CTX_set_min_proto_version(_client_ctx, to_ssl_version(*_settings._min_version));
+    params._min_version = to_ssl_version(*_settings._min_version);
   if (_settings._max_version)
-    SSL_CTX_set_max_proto_version(_client_ctx, to_ssl_version(*_settings._max_version));
+    params._max_version = to_ssl_version(*_settings._max_version);
 
     /*When we no longer need a read buffer or a write buffer for a given SSL, then
    * release the memory we were using to hold it. Using this flag can save
    * around 34k per idle SSL connection. This flag has no effect on SSL v2
    * connections, or on DTLS connections.*/
 #ifdef SSL_MODE_RELEASE_BUFFERS
-  SSL_CTX_set_mode(_client_ctx, SSL_MODE_RELEASE_BUFFERS);
+  params._mode |= SSL_MODE_RELEASE_BUFFERS;
 #endif
 
+  /* After SSL_ERROR_WANT_WRITE write is retried from the send buffer (other address, maybe bigger size).
+   * Partial write returns after every written record, hence unsent tail always stays in the send buffer */
+  params._mode |= SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER;
+
   unsigned long ctx_options = SSL_OP_ALL;
 
 #ifdef SSL_OP_NO_TICKET
-  ctx_options |= SSL_OP_NO_TICKET;
+  // session tickets are only useful with session cache
+  if (!_settings._enable_session_cache)
+    ctx_options |= SSL_OP_NO_TICKET;
 #endif
 
 #ifdef SSL_OP_NO_COMPRESSION
   ctx_options |= SSL_OP_NO_COMPRESSION;
 #endif
 
+#ifdef SSL_OP_ENABLE_KTLS
+  // openssl switches socket into kernel tls after handshake (if kernel and cipher support it)
+  if (_settings._enable_ktls)
+    ctx_options |= SSL_OP_ENABLE_KTLS;
+#endif
+
 #ifdef SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG
   /* mitigate CVE-2010-4180 */
   ctx_options &= ~SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG;
@@ -117,19 +130,20 @@ bool stream::init(settings *send_params) {
     //    SSL_CTX_set_alpn_protos(_client_ctx, proto_list.data(),
     //    proto_list.size());
   }
-  //NOTE: probably we can check return mask, but I don't see why we need it and how to handle it
-  SSL_CTX_set_options(_client_ctx, ctx_options);
-
-  if (!_settings._certificate_path.empty() && !_settings._key_path.empty()) {
-    if (!net::ssl::set_check_ceritficate(_client_ctx,
-                                         _settings._certificate_path,
-                                         _settings._key_path,
-                                         get_error_description())) {
-      set_connection_state(state::e_failed);
-      return false;
-    }
+  params._options = ctx_options;
+  params._certificate_path = _settings._certificate_path;
+  params._key_path = _settings._key_path;
+  if (_settings._enable_session_cache)
+    params._new_session_cb = &stream::new_session;
+
+  // streams with the same settings share context (certificate is loaded once)
+  std::string err;
+  _client_ctx = net::ssl::acquire_client_ctx(params, err);
+  if (!_client_ctx) {
+    append_error(get_error_description(), err);
+    set_connection_state(state::e_failed);
+    return false;
   }
-
   return true;
 }
 
@@ -148,6 +162,15 @@ bool stream::connection_established() {
   if (!_settings._host_name.empty())
     SSL_set_tlsext_host_name(_ctx, _settings._host_name.c_str());
 
+  if (_settings._enable_session_cache) {
+    // stream is taken in new session callback
+    SSL_set_app_data(_ctx, this);
+    if (SSL_SESSION *session = net::ssl::get_client_session(get_session_key())) {
+      SSL_set_session(_ctx, session);
+      SSL_SESSION_free(session);
+    }
+  }
+
   if (!SSL_set_fd(_ctx, get_fd())) {
     set_detailed_error(net::ssl::fill_error("couldn't set file decriptor to bio"));
     return false;
@@ -164,12 +187,80 @@ bool stream::connection_established() {
   return true;
 }
 
+std::string stream::get_session_key() const {
+  return net::ssl::get_client_session_prefix(_client_ctx) + _settings._peer_addr.to_string() + "/"
+         + _settings._host_name;
+}
+
+int stream::new_session(SSL *ssl, SSL_SESSION *session) {
+  auto *st = static_cast<stream *>(SSL_get_app_data(ssl));
+  if (!st)
+    return 0;
+  net::ssl::store_client_session(st->_client_ctx, st->get_session_key(), session);
+  return 1;
+}
+
+void stream::handshake_finished() {
+  // unfinished ssl write must be retried with ssl (record is in ssl buffer)
+  if (!SSL_is_init_finished(_ctx) || SSL_want_write(_ctx))
+    return;
+  _handshake_finished = true;
+  if (SSL_session_reused(_ctx))
+    ++_statistic._resumed_handshakes;
+  else
+    ++_statistic._full_handshakes;
+  // without kernel tls module (or openssl built without it) data is encrypted by ssl as usual
+  _ktls_send = BIO_get_ktls_send(SSL_get_wbio(_ctx));
+  _statistic._ktls_send = _ktls_send ? 1 : 0;
+  _statistic._ktls_recv = BIO_get_ktls_recv(SSL_get_rbio(_ctx)) ? 1 : 0;
+}
+
+template <typename Send> ssize_t stream::send_ktls(Send const &send_fn, size_t data_size) {
+  ssize_t sent{0};
+  while (true) {
+    sent = send_fn();
+    if (sent > 0) {
+      ++_statistic._success_send_data;
+      break;
+    }
+
+    if (-1 == sent && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
+    if (data_size == 0 && sent == 0)
+      break;
+
+    set_detailed_error(sent ? "kernel tls send return error" : "file is shorter than requested size");
+    ++_statistic._failed_send_data;
+    sent = -1;
+    break;
+  }
+  return sent;
+}
+
 ssize_t stream::send_data(std::byte const *data, size_t data_size) {
+  if (!_handshake_finished)
+    handshake_finished();
+  if (_ktls_send)
+    return send_ktls([&]() { return ::send(get_fd(), data, data_size, MSG_NOSIGNAL); }, data_size);
+
   ssize_t sent = -1;
   while (SSL_get_shutdown(_ctx) != SSL_RECEIVED_SHUTDOWN) {
     ERR_clear_error();
     sent = SSL_write(_ctx, data, data_size);
     if (sent > 0) {
+      _pending_write = 0;
       ++_statistic._success_send_data;
       break;
     }
@@ -180,20 +271,32 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
       ++_statistic._retry_send_data;
       // waiting data from peer
       // hence just buffer out data
+      set_pending_write(data_size);
       disable_send_cb();
       return 0;
     }
     case SSL_ERROR_WANT_WRITE: {
       ++_statistic._retry_send_data;
-      continue;
+      // socket buffer is full
+      // hence buffer out data and wait for write event
+      set_pending_write(data_size);
+      send_would_block();
+      return 0;
     }
 
     case SSL_ERROR_SYSCALL: {
-      if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+      if (EINTR == errno) {
+        errno = 0;
+        continue;
+      }
+      if (EAGAIN != errno && EWOULDBLOCK != errno) {
         set_detailed_error(net::ssl::fill_error("error occured while send data", err_c));
       } else {
+        errno = 0;
         ++_statistic._retry_send_data;
-        continue;
+        set_pending_write(data_size);
+        send_would_block();
+        return 0;
       }
       break;
     }
@@ -208,7 +311,54 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
   return sent;
 }
 
+ssize_t stream::send_data_v(iovec const *vec, size_t count) {
+  if (!_handshake_finished)
+    handshake_finished();
+  if (_ktls_send) {
+    // kernel makes records from gathered data itself
+    msghdr msg{};
+    msg.msg_iov = const_cast<iovec *>(vec);
+    msg.msg_iovlen = count < IOV_MAX ? count : IOV_MAX;
+    return send_ktls([&]() { return ::sendmsg(get_fd(), &msg, MSG_NOSIGNAL); }, strm::get_iovec_size(vec, count));
+  }
+
+  // gather buffers which fit into one record
+  size_t gathered = 0;
+  size_t i = 0;
+  for (; i < count && gathered + vec[i].iov_len <= SSL3_RT_MAX_PLAIN_LENGTH; ++i)
+    gathered += vec[i].iov_len;
+  // unfinished write must get at least the same amount of data. buffers can be shorter (segments of send buffer)
+  size_t const tail = i && i < count && gathered < _pending_write ? _pending_write - gathered : 0;
+  if (i < 2 && !tail)
+    return net::send::stream::send_data_v(vec, count);
+
+  _record.resize(gathered + tail);
+  for (size_t j = 0, offset = 0; j < i; offset += vec[j].iov_len, ++j)
+    std::memcpy(_record.data() + offset, vec[j].iov_base, vec[j].iov_len);
+  if (tail)
+    std::memcpy(_record.data() + gathered, vec[i].iov_base, tail);
+  gathered += tail;
+  ssize_t const sent = send_data(_record.data(), gathered);
+  // rest of partially gathered buffer is sent by caller
+  if (sent < 0 || (size_t) sent != gathered || i == count || tail)
+    return sent;
+  ssize_t const rest = send_data_v(vec + i, count - i);
+  return rest < 0 ? sent : sent + rest;
+}
+
+ssize_t stream::send_file_data(int file_fd, off_t offset, size_t size) {
+  if (!_handshake_finished)
+    handshake_finished();
+  if (_ktls_send)
+    return send_ktls([&]() { return ::sendfile(get_fd(), file_fd, &offset, size); }, size);
+  return net::send::stream::send_file_data(file_fd, offset, size);
+}
+
 ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
+  // control records (alerts, key updates, session tickets) are handled by ssl with kernel tls too,
+  // hence data is received with ssl read (openssl reads decrypted data from socket)
+  if (!_handshake_finished)
+    handshake_finished();
   ssize_t rec = -1;
   enable_send_cb();
   while (SSL_get_shutdown(_ctx) == 0) {
@@ -226,15 +376,23 @@ ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
       break;
     }
     case SSL_ERROR_SYSCALL: {
-      if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+      if (EINTR == errno) {
+        errno = 0;
+        continue;
+      }
+      if (EAGAIN != errno && EWOULDBLOCK != errno) {
         set_detailed_error(net::ssl::fill_error("error occured while receive ssl data", err_c));
       } else {
+        // no data yet. would block
+        errno = 0;
         ++_statistic._retry_recv_data;
-        continue;
+        receive_would_block();
+        return 0;
       }
       break;
     }
     case SSL_ERROR_WANT_READ: /* We need more data to finish the frame. */
+      receive_would_block();
       return 0;
     case SSL_ERROR_WANT_WRITE: {
       // TODO: Same as in grpc. need to check, maybe it is actual only for boringSSL
@@ -1,5 +1,9 @@
 #include <network/platforms/system.h>
 #include <network/udp/send/stream.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cstring>
+#include <netinet/udp.h>
 
 namespace bro::net::udp::send {
 
@@ -21,19 +25,31 @@ bool stream::init(settings *send_params) {
 
 ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
   ssize_t rec{0};
+  bool const gro = _settings._enable_gro;
+  iovec vec{buffer, buffer_size};
   while (true) {
-    rec = ::recv(get_fd(), buffer, buffer_size, MSG_NOSIGNAL);
+    rec = gro ? receive_gro(&vec, 1) : ::recv(get_fd(), buffer, buffer_size, MSG_NOSIGNAL);
     if (rec > 0) {
+      if (!gro)
+        _segment_size = rec;
       ++_statistic._success_recv_data;
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == rec && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_recv_data;
       continue;
     }
 
+    if (-1 == rec && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // no data yet. would block
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      rec = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (buffer_size == 0 && rec == 0)
       break;
@@ -46,6 +62,89 @@ ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
   return rec;
 }
 
+ssize_t stream::receivev(iovec *vec, size_t count) {
+  ssize_t rec{0};
+  bool const gro = _settings._enable_gro;
+  while (true) {
+    rec = gro ? receive_gro(vec, count) : ::readv(get_fd(), vec, count);
+    if (rec > 0) {
+      if (!gro)
+        _segment_size = rec;
+      ++_statistic._success_recv_data;
+      break;
+    }
+
+    if (-1 == rec && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == rec && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // no data yet. would block
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      rec = 0;
+      break;
+    }
+
+    // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
+    if (rec == 0 && strm::get_iovec_size(vec, count) == 0)
+      break;
+
+    set_detailed_error("readv return error");
+    ++_statistic._failed_recv_data;
+    rec = -1;
+    break;
+  }
+  return rec;
+}
+
+ssize_t stream::receive_gro(iovec *vec, size_t count) {
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msghdr msg{};
+  msg.msg_iov = vec;
+  msg.msg_iovlen = count;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t rec = ::recvmsg(get_fd(), &msg, MSG_NOSIGNAL);
+  if (rec <= 0)
+    return rec;
+
+  // not coalesced datagram doesn't have control message
+  _segment_size = rec;
+  for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+      int segment_size{0};
+      memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      _segment_size = segment_size;
+      break;
+    }
+  }
+  return rec;
+}
+
+bool stream::create_socket(proto::ip::address::version version, socket_type s_type) {
+  if (!net::stream::create_socket(version, s_type)) {
+    return false;
+  }
+  auto const *set = (udp::send::settings const *) get_settings();
+  if (set->_gso_segment_size && !set_udp_segment_size(get_fd(), *set->_gso_segment_size, get_error_description())) {
+    set_connection_state(state::e_failed);
+    return false;
+  }
+  if (set->_enable_gro && !enable_udp_gro(get_fd(), get_error_description())) {
+    set_connection_state(state::e_failed);
+    return false;
+  }
+  if (set->_zero_copy && !enable_zero_copy(get_fd(), get_error_description())) {
+    set_connection_state(state::e_failed);
+    return false;
+  }
+  return true;
+}
+
 bool stream::connect() {
   if (connect_stream(get_settings()->_peer_addr, get_fd(), get_error_description()))
     return true;
@@ -54,21 +153,32 @@ bool stream::connect() {
 }
 
 ssize_t stream::send_data(std::byte const *data, size_t data_size) {
+  int const zero_copy_flag = get_zero_copy_flag(data_size);
   // start to send
   ssize_t sent{0};
   while (true) {
-    sent = ::send(get_fd(), data, data_size, MSG_NOSIGNAL);
+    sent = ::send(get_fd(), data, data_size, MSG_NOSIGNAL | zero_copy_flag);
     if (sent > 0) {
+      if (zero_copy_flag)
+        zero_copy_sent();
       ++_statistic._success_send_data;
       break;
     }
 
-    if (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+    if (-1 == sent && EINTR == errno) {
       errno = 0;
-      ++_statistic._retry_send_data;
       continue;
     }
 
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
     // 0 may also be returned if the requested number of bytes to receive from a stream socket was 0
     if (data_size == 0 && sent == 0)
       break;
@@ -81,6 +191,172 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
   return sent;
 }
 
+ssize_t stream::send_data_v(iovec const *vec, size_t count) {
+  msghdr msg{};
+  msg.msg_iov = const_cast<iovec *>(vec);
+  msg.msg_iovlen = count;
+  int const zero_copy_flag = get_zero_copy_flag(strm::get_iovec_size(vec, count));
+  // start to send
+  ssize_t sent{0};
+  while (true) {
+    sent = ::sendmsg(get_fd(), &msg, MSG_NOSIGNAL | zero_copy_flag);
+    if (sent > 0) {
+      if (zero_copy_flag)
+        zero_copy_sent();
+      ++_statistic._success_send_data;
+      break;
+    }
+
+    if (-1 == sent && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (-1 == sent && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      // socket buffer is full. unsent data is buffered and sent on write event
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      sent = 0;
+      break;
+    }
+
+    // 0 may also be returned if the requested number of bytes to send was 0
+    if (sent == 0 && strm::get_iovec_size(vec, count) == 0)
+      break;
+
+    set_detailed_error("sendmsg return error");
+    ++_statistic._failed_send_data;
+    sent = -1;
+    break;
+  }
+  return sent;
+}
+
+ssize_t stream::send_batch(iovec const *datagrams, size_t count) {
+  if (get_state() != state::e_established)
+    return -1;
+
+  size_t const batch_size = _settings._batch_size ? _settings._batch_size : 1;
+  if (_send_msgs.size() < batch_size)
+    _send_msgs.resize(batch_size);
+
+  size_t sent_overall{0};
+  while (sent_overall < count) {
+    size_t const to_send = std::min(batch_size, count - sent_overall);
+    for (size_t i = 0; i < to_send; ++i) {
+      _send_msgs[i] = {};
+      _send_msgs[i].msg_hdr.msg_iov = const_cast<iovec *>(&datagrams[sent_overall + i]);
+      _send_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int const sent = ::sendmmsg(get_fd(), _send_msgs.data(), (unsigned int) to_send, MSG_NOSIGNAL);
+    if (sent > 0) {
+      ++_statistic._batch_send_calls;
+      _statistic._batch_sent_datagrams += sent;
+      _statistic._success_send_data += sent;
+      sent_overall += sent;
+      if ((size_t) sent != to_send)
+        break;
+      continue;
+    }
+
+    if (EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (EAGAIN == errno || EWOULDBLOCK == errno) {
+      // socket buffer is full. caller will retry rest of datagrams
+      errno = 0;
+      ++_statistic._retry_send_data;
+      send_would_block();
+      break;
+    }
+
+    set_detailed_error("sendmmsg return error");
+    ++_statistic._failed_send_data;
+    return sent_overall ? sent_overall : -1;
+  }
+  return sent_overall;
+}
+
+bool stream::set_received_batch_cb(received_batch_cb cb, std::any param) {
+  _received_batch_cb = cb;
+  _param_received_batch_cb = param;
+  if (!_received_batch_cb) {
+    set_received_data_cb(nullptr, {});
+    return true;
+  }
+
+  size_t const batch_size = _settings._batch_size ? _settings._batch_size : 1;
+  size_t const datagram_size = _settings._batch_datagram_size;
+  _recv_buffer.resize(batch_size * datagram_size);
+  _recv_msgs.resize(batch_size);
+  _recv_iovecs.resize(batch_size);
+  _recv_datagrams.resize(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    _recv_iovecs[i].iov_base = _recv_buffer.data() + i * datagram_size;
+    _recv_iovecs[i].iov_len = datagram_size;
+  }
+  set_received_data_cb([this](strm::stream *, std::any) { receive_batch(); }, {});
+  return true;
+}
+
+void stream::receive_batch() {
+  size_t const batch_size = _recv_msgs.size();
+  for (size_t i = 0; i < batch_size; ++i) {
+    _recv_msgs[i] = {};
+    _recv_msgs[i].msg_hdr.msg_iov = &_recv_iovecs[i];
+    _recv_msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int rec{-1};
+  while (true) {
+    rec = ::recvmmsg(get_fd(), _recv_msgs.data(), (unsigned int) batch_size, MSG_DONTWAIT, nullptr);
+    if (rec > 0)
+      break;
+
+    if (-1 == rec && EINTR == errno) {
+      errno = 0;
+      continue;
+    }
+
+    if (0 == rec || EAGAIN == errno || EWOULDBLOCK == errno) {
+      // nothing to read yet. wait next read event
+      errno = 0;
+      ++_statistic._retry_recv_data;
+      receive_would_block();
+      return;
+    }
+
+    // failure is reported with state callback (it can destroy stream)
+    ++_statistic._failed_recv_data;
+    set_detailed_error("recvmmsg return error");
+    return;
+  }
+
+  // batch isn't filled, hence receive queue is empty
+  if ((size_t) rec < batch_size)
+    receive_would_block();
+  ++_statistic._batch_recv_calls;
+  _statistic._batch_received_datagrams += rec;
+  size_t passed{0};
+  for (int i = 0; i < rec; ++i) {
+    // datagram doesn't fit into buffer. tail is lost, hence it isn't passed as whole datagram
+    if (_recv_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      ++_statistic._truncated_datagrams;
+      continue;
+    }
+    _recv_datagrams[passed].iov_base = _recv_iovecs[i].iov_base;
+    _recv_datagrams[passed].iov_len = _recv_msgs[i].msg_len;
+    ++passed;
+  }
+  _statistic._success_recv_data += passed;
+  if (passed)
+    _received_batch_cb(this, _recv_datagrams.data(), passed, _param_received_batch_cb);
+}
+
 void stream::reset_statistic() {
   _statistic.reset();
 }
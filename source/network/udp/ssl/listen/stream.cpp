@@ -136,11 +136,11 @@ stream::~stream() {
   stream::cleanup();
 }
 
-std::unique_ptr<net::stream> stream::generate_send_stream() {
-  return std::make_unique<bro::net::udp::ssl::send::stream>();
+stream::send_stream_ptr stream::generate_send_stream() {
+  return make_send_stream<bro::net::udp::ssl::send::stream>();
 }
 
-bool stream::fill_send_stream(accept_connection_res const &result, std::unique_ptr<net::stream> &sck) {
+bool stream::fill_send_stream(accept_connection_res const &result, send_stream_ptr &sck) {
   if (!net::listen::stream::fill_send_stream(result, sck))
     return false;
 
@@ -173,6 +173,7 @@ bool stream::fill_send_stream(accept_connection_res const &result, std::unique_p
 bool stream::create_listen_socket() {
   if (create_socket(_settings._listen_address.get_address().get_version(), socket_type::e_udp)
       && reuse_address(get_fd(), get_error_description())
+      && (!_settings._reuse_port || reuse_port(get_fd(), get_error_description()))
       && bind_on_address(_settings._listen_address, get_fd(), get_error_description()))
     return true;
   set_connection_state(state::e_failed);
@@ -194,7 +195,7 @@ void stream::handle_incoming_connection() {
     if (!_settings._proc_in_conn)
       return;
 
-    auto sck = std::make_unique<bro::net::udp::ssl::send::stream>();
+    auto sck = make_send_stream<bro::net::udp::ssl::send::stream>();
     sck->_settings._self_addr = _settings._listen_address;
     sck->_ctx = _dtls_ctx;
 
@@ -250,6 +251,9 @@ void stream::handle_incoming_connection() {
       _statistic._failed_to_accept_connections++;
     _settings._proc_in_conn(std::move(sck), _settings._in_conn_handler_data);
     generate_new_dtls_context();
+  } else {
+    // nothing to read or hello without cookie. if datagrams are left in socket client retransmits hello
+    accept_would_block();
   }
 }
 
@@ -292,6 +296,9 @@ bool stream::init(settings *listen_params) {
     return false;
   }
 
+  /* After SSL_ERROR_WANT_WRITE write is retried from the send buffer (other address) */
+  SSL_CTX_set_mode(_server_ctx, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
   ctx_option_t ctx_options = (SSL_OP_ALL & ~SSL_OP_DONT_INSERT_EMPTY_FRAGMENTS);
 
 #ifdef SSL_OP_NETSCAPE_REUSE_CIPHER_CHANGE_BUG
@@ -12,7 +12,7 @@ stream::~stream() {
 
 void stream::cleanup() {
   if (_client_ctx) {
-    SSL_CTX_free(_client_ctx);
+    net::ssl::release_client_ctx(_client_ctx);
     _client_ctx = nullptr;
   }
 
@@ -36,16 +36,20 @@ bool stream::init(settings *send_params) {
   }
   _settings = *send_params;
 
+  // kernel would split/merge encrypted records
+  if (_settings._gso_segment_size || _settings._enable_gro) {
+    set_detailed_error("UDP_SEGMENT/UDP_GRO aren't supported by dtls stream");
+    return false;
+  }
+
   if (!create_socket(_settings._peer_addr.get_address().get_version(), socket_type::e_udp))
     return false;
   ERR_clear_error();
 
-  _client_ctx = SSL_CTX_new(DTLS_client_method());
-
-  if (!_client_ctx) {
-    set_detailed_error(net::ssl::fill_error("couldn't create client dtls contexts"));
-    return false;
-  }
+  net::ssl::client_ctx_params params;
+  params._method = DTLS_client_method();
+  /* After SSL_ERROR_WANT_WRITE write is retried from the send buffer (other address) */
+  params._mode = SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER;
 
   unsigned long ctx_options = SSL_OP_ALL;
 
@@ -68,18 +72,18 @@ bool stream::init(settings *send_params) {
     ctx_options |= SSL_OP_NO_SSLv2;
   }
 
-  //NOTE: probably we can check return mask, but I don't see why we need it and how to handle it
-  SSL_CTX_set_options(_client_ctx, ctx_options);
+  params._options = ctx_options;
+  params._verify_depth = 2;
+  params._certificate_path = _settings._certificate_path;
+  params._key_path = _settings._key_path;
 
-  if (!_settings._certificate_path.empty() && !_settings._key_path.empty()) {
-    if (!net::ssl::set_check_ceritficate(_client_ctx,
-                                         _settings._certificate_path,
-                                         _settings._key_path,
-                                         get_error_description())) {
-      set_connection_state(state::e_failed);
-      return false;
-    }
-    SSL_CTX_set_verify_depth(_client_ctx, 2);
+  // streams with the same settings share context (certificate is loaded once)
+  std::string err;
+  _client_ctx = net::ssl::acquire_client_ctx(params, err);
+  if (!_client_ctx) {
+    append_error(get_error_description(), err);
+    set_connection_state(state::e_failed);
+    return false;
   }
 
   _ctx = SSL_new(_client_ctx);
@@ -132,6 +136,16 @@ bool stream::connection_established() {
   return true;
 }
 
+ssize_t stream::send_batch(iovec const * /*datagrams*/, size_t /*count*/) {
+  set_detailed_error("batch send isn't supported by dtls stream");
+  return -1;
+}
+
+bool stream::set_received_batch_cb(udp::send::received_batch_cb /*cb*/, std::any /*param*/) {
+  set_detailed_error("batch receive isn't supported by dtls stream");
+  return false;
+}
+
 ssize_t stream::send_data(std::byte const *data, size_t data_size) {
   ssize_t sent = -1;
   while (SSL_get_shutdown(_ctx) != SSL_RECEIVED_SHUTDOWN) {
@@ -153,15 +167,24 @@ ssize_t stream::send_data(std::byte const *data, size_t data_size) {
     }
     case SSL_ERROR_WANT_WRITE: {
       ++_statistic._retry_send_data;
-      continue;
+      // socket buffer is full
+      // hence buffer out data and wait for write event
+      send_would_block();
+      return 0;
     }
 
     case SSL_ERROR_SYSCALL: {
-      if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+      if (EINTR == errno) {
+        errno = 0;
+        continue;
+      }
+      if (EAGAIN != errno && EWOULDBLOCK != errno) {
         set_detailed_error(net::ssl::fill_error("error occured while send data", err_c));
       } else {
+        errno = 0;
         ++_statistic._retry_send_data;
-        continue;
+        send_would_block();
+        return 0;
       }
       break;
     }
@@ -194,15 +217,23 @@ ssize_t stream::receive(std::byte *buffer, size_t buffer_size) {
       break;
     }
     case SSL_ERROR_SYSCALL: {
-      if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+      if (EINTR == errno) {
+        errno = 0;
+        continue;
+      }
+      if (EAGAIN != errno && EWOULDBLOCK != errno) {
         set_detailed_error(net::ssl::fill_error("error occured while receive ssl data", err_c));
       } else {
+        // no data yet. would block
+        errno = 0;
         ++_statistic._retry_recv_data;
-        continue;
+        receive_would_block();
+        return 0;
       }
       break;
     }
     case SSL_ERROR_WANT_READ: /* We need more data to finish the frame. */
+      receive_would_block();
       return 0;
     case SSL_ERROR_WANT_WRITE: {
       // TODO: Same as in grpc. need to check, maybe it is actual only for boringSSL